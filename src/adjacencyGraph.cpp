@@ -0,0 +1,161 @@
+#include "adjacencyGraph.h"
+#include "utils.h"
+#include <algorithm>
+#include <cassert>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+/// @brief Add `polygon` as node `polygon.getId()` and link it to the polygons
+/// it shares a side with.
+/// @param polygon its id should be the number of nodes
+/// @param geometry world-space vertices including those of `polygon`
+void AdjacencyGraph::addPolygon(const Polygon& polygon,
+                                const WorldGeometry& geometry) {
+    const int id = polygon.getId();
+    assert(id == size());
+    neighbors.emplace_back();
+    for (auto& match : findMatches(id, polygon.nbSides, geometry)) {
+        neighbors[id].emplace_back(match.polygon, match.edge);
+        neighbors[match.polygon].emplace_back(id, match.otherEdge);
+        edgeCount++;
+    }
+    for (int n = 0; n < polygon.nbSides; n++) {
+        dvec2 a = geometry.getVertex(id, n);
+        dvec2 b = geometry.getVertex(id, n + 1);
+        grid[cellOf(a, b)].emplace_back(id, n, a, b);
+    }
+}
+
+/// @brief Recompute the graph of `polygons` from scratch.
+///
+/// The sides are hashed sequentially, then the neighbors of ranges of
+/// polygons are searched in parallel.
+/// @param polygons polygons indexed by id
+/// @param geometry world-space vertices of `polygons`
+/// @param pool
+void AdjacencyGraph::build(
+    const std::vector<std::shared_ptr<Polygon>>& polygons,
+    const WorldGeometry& geometry, ThreadPool& pool) {
+    clear();
+    neighbors.resize(polygons.size());
+    for (std::size_t id = 0; id < polygons.size(); id++) {
+        for (int n = 0; n < polygons[id]->nbSides; n++) {
+            dvec2 a = geometry.getVertex(id, n);
+            dvec2 b = geometry.getVertex(id, n + 1);
+            grid[cellOf(a, b)].emplace_back(id, n, a, b);
+        }
+    }
+    pool.parallelFor(0, polygons.size(), [&](int begin, int end) {
+        for (int id = begin; id < end; id++) {
+            auto matches = findMatches(id, polygons[id]->nbSides, geometry);
+            for (auto& match : matches) {
+                neighbors[id].emplace_back(match.polygon, match.edge);
+            }
+        }
+    });
+    for (auto& list : neighbors) {
+        edgeCount += list.size();
+    }
+    edgeCount /= 2;
+}
+
+/// @brief Remove `polygon`, which should be the node added last.
+/// @param polygon
+/// @param geometry world-space vertices including those of `polygon`
+void AdjacencyGraph::removeLastPolygon(const Polygon& polygon,
+                                       const WorldGeometry& geometry) {
+    const int id = polygon.getId();
+    assert(id == size() - 1);
+    for (int n = 0; n < polygon.nbSides; n++) {
+        GridCell key =
+            cellOf(geometry.getVertex(id, n), geometry.getVertex(id, n + 1));
+        auto cell = grid.find(key);
+        if (cell == grid.end()) {
+            continue;
+        }
+        auto& sides = cell->second;
+        sides.erase(std::remove_if(sides.begin(), sides.end(),
+                                   [id](const Side& side) {
+                                       return side.polygon == id;
+                                   }),
+                    sides.end());
+        if (sides.empty()) {
+            grid.erase(cell);
+        }
+    }
+    for (auto& neighbor : neighbors[id]) {
+        auto& list = neighbors[neighbor.polygon];
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [id](const Neighbor& other) {
+                                      return other.polygon == id;
+                                  }),
+                   list.end());
+    }
+    edgeCount -= neighbors[id].size();
+    neighbors.pop_back();
+}
+
+void AdjacencyGraph::clear() {
+    grid.clear();
+    neighbors.clear();
+    edgeCount = 0;
+}
+
+/// @brief Number of nodes.
+int AdjacencyGraph::size() const { return neighbors.size(); }
+
+/// @brief Number of shared sides (each counted once).
+int AdjacencyGraph::getEdgeCount() const { return edgeCount; }
+
+const std::vector<AdjacencyGraph::Neighbor>&
+AdjacencyGraph::getNeighbors(const int polygon) const {
+    return neighbors[polygon];
+}
+
+/// @brief Find the sides in `grid` overlapping with a side of polygon `id`,
+/// ignoring the sides of polygon `id` itself.
+std::vector<AdjacencyGraph::Match>
+AdjacencyGraph::findMatches(const int id, const int nbSides,
+                            const WorldGeometry& geometry) const {
+    std::vector<Match> matches{};
+    for (int n = 0; n < nbSides; n++) {
+        dvec2 a = geometry.getVertex(id, n);
+        dvec2 b = geometry.getVertex(id, n + 1);
+        GridCell center = cellOf(a, b);
+        for (long long dx = -1; dx <= 1; dx++) {
+            for (long long dy = -1; dy <= 1; dy++) {
+                auto cell = grid.find(GridCell(center.x + dx, center.y + dy));
+                if (cell == grid.end()) {
+                    continue;
+                }
+                for (auto& side : cell->second) {
+                    // overlapping sides of adjacent polygons run in opposite
+                    // directions
+                    if (side.polygon != id &&
+                        distance(side.a, b) < DISTANCE_THRESHOLD &&
+                        distance(side.b, a) < DISTANCE_THRESHOLD) {
+                        matches.emplace_back(n, side.polygon, side.edge);
+                    }
+                }
+            }
+        }
+    }
+    return matches;
+}
+
+GridCell AdjacencyGraph::cellOf(const dvec2& a, const dvec2& b) {
+    return GridCell((a + b) / 2.0, DISTANCE_THRESHOLD);
+}
+
+/// @brief Bytes used by the sides hashed in the grid and the neighbors.
+std::size_t AdjacencyGraph::getMemoryUsage() const {
+    std::size_t bytes = unorderedMapBytes(grid) + vectorBytes(neighbors);
+    for (auto& cell : grid) {
+        bytes += vectorBytes(cell.second);
+    }
+    for (auto& polygonNeighbors : neighbors) {
+        bytes += vectorBytes(polygonNeighbors);
+    }
+    return bytes;
+}
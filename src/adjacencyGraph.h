@@ -0,0 +1,67 @@
+#ifndef ADJACENCY_GRAPH_H
+#define ADJACENCY_GRAPH_H
+
+#include "gridCell.h"
+#include "memoryUsage.h"
+#include "polygon.h"
+#include "threadPool.h"
+#include "worldGeometry.h"
+#include <glm/vec2.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Graph of the polygons of a tiling where polygons sharing a side are
+/// adjacent (the dual graph of the tiling).
+///
+/// Nodes are polygon ids, which must be added in increasing order from 0.
+/// Shared sides are found geometrically by hashing side midpoints, so every
+/// overlap is detected, contiguous or not.
+class AdjacencyGraph {
+  public:
+    struct Neighbor {
+        int polygon{};
+        // side of this polygon shared with `polygon`
+        int edge{};
+        Neighbor(int polygon, int edge) : polygon(polygon), edge(edge) {};
+    };
+
+  private:
+    struct Side {
+        int polygon{};
+        int edge{};
+        glm::dvec2 a{};
+        glm::dvec2 b{};
+        Side(int polygon, int edge, const glm::dvec2& a, const glm::dvec2& b)
+            : polygon(polygon), edge(edge), a(a), b(b) {};
+    };
+    struct Match {
+        int edge{};
+        int polygon{};
+        int otherEdge{};
+        Match(int edge, int polygon, int otherEdge)
+            : edge(edge), polygon(polygon), otherEdge(otherEdge) {};
+    };
+    // sides are stored in the grid cell of their midpoint
+    std::unordered_map<GridCell, std::vector<Side>, GridCellHash> grid{};
+    std::vector<std::vector<Neighbor>> neighbors{};
+    int edgeCount{};
+
+    static GridCell cellOf(const glm::dvec2& a, const glm::dvec2& b);
+    std::vector<Match> findMatches(const int id, const int nbSides,
+                                   const WorldGeometry& geometry) const;
+
+  public:
+    void addPolygon(const Polygon& polygon, const WorldGeometry& geometry);
+    void removeLastPolygon(const Polygon& polygon,
+                           const WorldGeometry& geometry);
+    void build(const std::vector<std::shared_ptr<Polygon>>& polygons,
+               const WorldGeometry& geometry, ThreadPool& pool);
+    void clear();
+    int size() const;
+    int getEdgeCount() const;
+    const std::vector<Neighbor>& getNeighbors(const int polygon) const;
+    std::size_t getMemoryUsage() const;
+};
+
+#endif /* ADJACENCY_GRAPH_H */
@@ -0,0 +1,423 @@
+#include "benchmark.h"
+#include "dualGraph.h"
+#include "scene.h"
+#include "threadPool.h"
+#include "tiling.h"
+#include "tilingFile.h"
+#include "utils.h"
+#include "worldGeometry.h"
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace glm;
+
+/// @brief Seconds elapsed since `start`.
+static double
+secondsSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+/// @brief Discard what is written to `stream` while in scope.
+class StreamSilencer {
+    std::ostream& stream;
+    std::streambuf* buffer{};
+
+  public:
+    StreamSilencer(std::ostream& stream = std::clog)
+        : stream(stream), buffer(stream.rdbuf(nullptr)) {}
+    ~StreamSilencer() {
+        stream.rdbuf(buffer);
+        stream.clear();
+    }
+    StreamSilencer(const StreamSilencer&) = delete;
+    StreamSilencer& operator=(const StreamSilencer&) = delete;
+};
+
+/// @brief Grow `tiling` by `nbPolygons` triangles.
+/// Adding triangles on the edge cursor without moving it builds a spiral,
+/// which stays a proper tiling much longer than with squares or hexagons.
+static void growTiling(Tiling& tiling, const int nbPolygons) {
+    for (int n = 0; n < nbPolygons; n++) {
+        tiling.addPolygon(3);
+    }
+}
+
+/// @brief Run all benchmarks and print their results to `stream`.
+void runBenchmarks(std::ostream& stream) {
+    benchmarkVertexTransforms(stream);
+    benchmarkParallelRebuild(stream);
+    benchmarkTilingFile(stream);
+}
+
+/// @brief Measure the throughput of the vertex transform kernels on random
+/// polygons with 3 to 12 sides, in vertices per second.
+void benchmarkVertexTransforms(std::ostream& stream) {
+    const int nbPolygons = 200000;
+    const int nbRepetitions = 20;
+    std::mt19937 random(0);
+    std::uniform_int_distribution<int> sides(3, 12);
+    std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+
+    // unit polygons, padded like in `WorldGeometry`
+    std::vector<std::vector<double>> unitXs(13), unitYs(13);
+    for (int nbSides = 3; nbSides <= 12; nbSides++) {
+        int padded = (nbSides + SIMD_WIDTH) / SIMD_WIDTH * SIMD_WIDTH;
+        std::vector<dvec2> points = regularPolygon(nbSides);
+        for (int n = 0; n < padded; n++) {
+            dvec2 point = points[n <= nbSides ? n : 0];
+            unitXs[nbSides].push_back(point.x);
+            unitYs[nbSides].push_back(point.y);
+        }
+    }
+    std::vector<int> polygonSides(nbPolygons);
+    std::vector<dmat3x2> matrices(nbPolygons);
+    std::vector<int> offsets(nbPolygons + 1, 0);
+    for (int p = 0; p < nbPolygons; p++) {
+        polygonSides[p] = sides(random);
+        dvec2 a(coordinate(random), coordinate(random));
+        double angle = coordinate(random);
+        dvec2 diff = 0.2 * dvec2(std::cos(angle), std::sin(angle));
+        matrices[p] = dmat3x2(diff.x, diff.y, -diff.y, diff.x, a.x, a.y);
+        offsets[p + 1] = offsets[p] + unitXs[polygonSides[p]].size();
+    }
+    std::vector<double> xs(offsets.back()), ys(offsets.back());
+    std::vector<double> scalarXs(offsets.back()), scalarYs(offsets.back());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < nbRepetitions; repetition++) {
+        for (int p = 0; p < nbPolygons; p++) {
+            int n = polygonSides[p];
+            transformPointsScalar(matrices[p], unitXs[n].data(),
+                                  unitYs[n].data(), offsets[p + 1] - offsets[p],
+                                  &scalarXs[offsets[p]], &scalarYs[offsets[p]]);
+        }
+    }
+    double scalarTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < nbRepetitions; repetition++) {
+        for (int p = 0; p < nbPolygons; p++) {
+            int n = polygonSides[p];
+            transformPoints(matrices[p], unitXs[n].data(), unitYs[n].data(),
+                            offsets[p + 1] - offsets[p], &xs[offsets[p]],
+                            &ys[offsets[p]]);
+        }
+    }
+    double simdTime = secondsSince(start);
+
+    double maxError = 0.0;
+    for (std::size_t n = 0; n < xs.size(); n++) {
+        maxError = std::max(maxError, std::abs(xs[n] - scalarXs[n]));
+        maxError = std::max(maxError, std::abs(ys[n] - scalarYs[n]));
+    }
+    double vertices = static_cast<double>(offsets.back()) * nbRepetitions;
+    stream << "Vertex transforms (" << nbPolygons << " polygons, "
+           << offsets.back() << " vertices with padding)" << std::endl;
+    stream << "  scalar: " << vertices / scalarTime / 1e6 << " Mvertices/s"
+           << std::endl;
+    stream << "  " << vertexKernelName() << ": "
+           << vertices / simdTime / 1e6 << " Mvertices/s (max error "
+           << maxError << ")" << std::endl;
+}
+
+/// @brief Measure how the whole-tiling passes scale from 1 thread to the
+/// number of hardware threads, and check that they give the same results.
+void benchmarkParallelRebuild(std::ostream& stream) {
+    const int nbPolygons = 100000;
+    const int nbRepetitions = 5;
+    // polygons log their creation and deletion
+    StreamSilencer silencer{};
+    Tiling tiling{};
+    growTiling(tiling, nbPolygons);
+    stream << "Parallel rebuild (" << tiling.getPolygons().size()
+           << " polygons)" << std::endl;
+
+    // powers of two, then all the hardware threads
+    const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts{};
+    for (int nbThreads = 1; nbThreads < maxThreads; nbThreads *= 2) {
+        threadCounts.push_back(nbThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double sequentialTime = 0.0;
+    std::vector<int> reference{};
+    auto referenceHistogram = tiling.getVertices().getHistogram();
+    for (int nbThreads : threadCounts) {
+        ThreadPool pool(nbThreads);
+        auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < nbRepetitions; repetition++) {
+            tiling.rebuild(pool);
+        }
+        double rebuildTime = secondsSince(start) / nbRepetitions;
+        start = std::chrono::steady_clock::now();
+        DualGraph dual(tiling.getGraph(), tiling.getPolygons(), pool);
+        double exportTime = secondsSince(start);
+
+        if (nbThreads == 1) {
+            sequentialTime = rebuildTime;
+            reference = dual.neighbors;
+        }
+        bool same = dual.neighbors == reference &&
+                    tiling.getVertices().getHistogram() == referenceHistogram;
+        stream << "  " << nbThreads << " threads: rebuild " << rebuildTime
+               << "s (speedup " << sequentialTime / rebuildTime
+               << "), dual graph " << exportTime << "s"
+               << (same ? "" : ", results differ!") << std::endl;
+    }
+    tiling.getVertices().report(stream);
+    // bytes per polygon, the GPU buffers being those the scene would fill
+    MemoryUsage usage{};
+    tiling.getMemoryUsage(usage);
+    Scene scene{};
+    scene.capture(tiling, dvec2(0.0));
+    // one segment instance per boundary edge, plus the cursor and crosshair
+    const std::size_t nbSegments = scene.boundary.size() / 2 + 3;
+    usage.gpuBuffers =
+        sizeof(PolygonInstance) * (scene.instances.size() + nbSegments);
+    usage.report(stream, tiling.getPolygons().size());
+}
+
+/// @brief Measure how fast a tiling is saved to a text file, parsed, and
+/// loaded (parsed then added to the tiling), in MB/s of text.
+void benchmarkTilingFile(std::ostream& stream) {
+    const int nbPolygons = 100000;
+    const char* filename = "benchmark_tiling.txt";
+    StreamSilencer silencer{};
+    Tiling tiling{};
+    growTiling(tiling, nbPolygons);
+
+    auto start = std::chrono::steady_clock::now();
+    tiling.save(filename);
+    double saveTime = secondsSince(start);
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream text{};
+    text << file.rdbuf();
+    file.close();
+    std::remove(filename);
+    const std::string content = text.str();
+    const double megabytes = content.size() / 1e6;
+
+    // from memory, to leave the disk out
+    std::istringstream parsed(content);
+    TilingReader reader(parsed);
+    TilingRecord record{};
+    int nbRecords = 0;
+    start = std::chrono::steady_clock::now();
+    while (reader.next(record)) {
+        nbRecords++;
+    }
+    double parseTime = secondsSince(start);
+
+    std::istringstream loaded(content);
+    TilingReader loader(loaded);
+    Tiling copy{};
+    start = std::chrono::steady_clock::now();
+    while (loader.next(record)) {
+        copy.load(record);
+    }
+    double loadTime = secondsSince(start);
+
+    bool same = copy.getPolygons().size() == tiling.getPolygons().size() &&
+                copy.getEdges().size() == tiling.getEdges().size() &&
+                copy.getVertices().getHistogram() ==
+                    tiling.getVertices().getHistogram();
+    stream << "Tiling file (" << tiling.getPolygons().size() << " polygons, "
+           << nbRecords << " lines, " << megabytes << " MB)" << std::endl;
+    stream << "  save: " << megabytes / saveTime << " MB/s" << std::endl;
+    stream << "  parse: " << megabytes / parseTime << " MB/s" << std::endl;
+    stream << "  load: " << megabytes / loadTime << " MB/s"
+           << (same ? "" : ", loaded tiling differs!") << std::endl;
+}
+
+static const char* STRESS_USAGE =
+    "Usage: main --stress [options]\n"
+    "  --steps N            random operations (default 1000000)\n"
+    "  --check-every K      check the invariants every K operations\n"
+    "                       (default 1000, 1 to check after each)\n"
+    "  --max-polygons N     remove polygons beyond N (default 2000)\n"
+    "  --seed SEED          seed of the operations (default 1)\n"
+    "  --strict             fail on overlapping edges too\n";
+
+/// @brief Read the whole of `text` as a decimal integer from `min` to `max`.
+/// @return whether it is one, `value` is unchanged otherwise
+static bool parseInteger(const std::string& text, const long min,
+                         const long max, long& value) {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end || errno == ERANGE || parsed < min ||
+        parsed > max) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/// @brief Apply random operations to a tiling, checking
+/// `Tiling::checkInvariants` every `--check-every` operations and at the
+/// end, and print how many operations ran per second.
+/// Overlapping edges, which `Tiling` doesn't always detect, are counted at
+/// each check, and only break the invariants with `--strict`.
+///
+/// Each operation adds a polygon on the edge cursor if it fits, moves the
+/// cursor a few edges, or removes the last polygon, which always happens
+/// past `--max-polygons`, and the tiling is emptied if that polygon can't
+/// be removed. The operations only
+/// depend on the seed, so a broken invariant is reproduced, and narrowed
+/// down to one operation, by running again with `--check-every 1`.
+/// @param stream
+/// @param arguments command line arguments after `--stress`
+/// @return exit code, 0 if the invariants held
+int runStressTest(std::ostream& stream,
+                  const std::vector<std::string>& arguments) {
+    long steps = 1000000;
+    long checkEvery = 1000;
+    std::size_t maxPolygons = 2000;
+    unsigned seed = 1;
+    bool strict = false;
+    for (std::size_t n = 0; n < arguments.size(); n++) {
+        const std::string& argument = arguments[n];
+        if (argument == "--strict") {
+            strict = true;
+            continue;
+        }
+        if (n + 1 >= arguments.size()) {
+            std::cerr << STRESS_USAGE;
+            return 1;
+        }
+        const std::string& value = arguments[++n];
+        long parsed = 0;
+        bool valid = false;
+        if (argument == "--steps") {
+            valid = parseInteger(value, 0, LONG_MAX, steps);
+        } else if (argument == "--check-every") {
+            valid = parseInteger(value, 1, LONG_MAX, checkEvery);
+        } else if (argument == "--max-polygons") {
+            valid = parseInteger(value, 0, INT_MAX, parsed);
+            maxPolygons = parsed;
+        } else if (argument == "--seed") {
+            valid = parseInteger(value, 0, UINT_MAX, parsed);
+            seed = parsed;
+        }
+        if (!valid) {
+            logError("Invalid stress test option.");
+            std::cerr << STRESS_USAGE;
+            return 1;
+        }
+    }
+    stream << "Stress test (seed " << seed << ", " << steps
+           << " operations, invariants checked every " << checkEvery << ")"
+           << std::endl;
+
+    static const int NB_SIDES[] = {3, 4, 6, 8, 12};
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> operations(0, 99);
+    std::uniform_int_distribution<int> sides(0, 4);
+    std::uniform_int_distribution<int> moves(1, 4);
+    long added = 0, rejected = 0, moved = 0, removed = 0, unremoved = 0;
+    long restarts = 0;
+    long nbChecks = 0;
+    // checks finding overlapping edges, and the most pairs found
+    long overlappingChecks = 0;
+    std::size_t maxOverlaps = 0;
+    double checkTime = 0.0;
+    std::string error{};
+    // operations applied since the last check
+    long checkedSteps = 0;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        // polygons log their creation and deletion
+        StreamSilencer silencer{};
+        Tiling tiling{};
+        for (long step = 1; step <= steps; step++) {
+            const int operation = operations(random);
+            const std::size_t nbPolygons = tiling.getPolygons().size();
+            if (nbPolygons < maxPolygons && operation < 45) {
+                const int nbSides = NB_SIDES[sides(random)];
+                if (tiling.canAddPolygon(nbSides)) {
+                    tiling.addPolygon(nbSides);
+                    added++;
+                } else {
+                    rejected++;
+                }
+            } else if (nbPolygons < maxPolygons && operation < 85) {
+                const bool forward = operation % 2;
+                for (int move = moves(random); move > 0; move--) {
+                    if (forward) {
+                        tiling.nextEdge();
+                    } else {
+                        tiling.prevEdge();
+                    }
+                }
+                moved++;
+            } else if (tiling.canRemoveLastPolygon()) {
+                tiling.removeLastPolygon();
+                removed++;
+            } else if (nbPolygons) {
+                // the removal of surrounded polygons isn't implemented
+                unremoved++;
+                // start over rather than stay stuck at the maximum
+                if (nbPolygons >= maxPolygons) {
+                    tiling.removeAllPolygons();
+                    restarts++;
+                }
+            }
+            if (step % checkEvery == 0 || step == steps) {
+                const auto checkStart = std::chrono::steady_clock::now();
+                bool valid = tiling.checkInvariants(error);
+                const std::size_t overlaps = tiling.countOverlappingEdges();
+                checkTime += secondsSince(checkStart);
+                nbChecks++;
+                if (overlaps) {
+                    overlappingChecks++;
+                    maxOverlaps = std::max(maxOverlaps, overlaps);
+                    if (strict && valid) {
+                        error = std::to_string(overlaps) +
+                                " pairs of edges overlap.";
+                        valid = false;
+                    }
+                }
+                if (!valid) {
+                    break;
+                }
+                checkedSteps = step;
+            }
+        }
+    }
+    const double operationTime = secondsSince(start) - checkTime;
+    stream << "  " << added << " polygons added (" << rejected
+           << " didn't fit), " << removed << " removed (" << unremoved
+           << " not removable), " << moved << " cursor moves, " << restarts
+           << " restarts from an empty tiling" << std::endl;
+    stream << "  " << (added + rejected + removed + unremoved + moved) /
+                          operationTime
+           << " operations/s, " << nbChecks << " checks in " << checkTime
+           << "s" << std::endl;
+    stream << "  Overlapping edges in " << overlappingChecks
+           << " checks (at most " << maxOverlaps << " pairs)" << std::endl;
+    if (!error.empty()) {
+        const long lastStep = std::min(checkedSteps + checkEvery, steps);
+        stream << "  Invariant broken by operation ";
+        if (lastStep > checkedSteps + 1) {
+            stream << checkedSteps + 1 << " to ";
+        }
+        stream << lastStep << ": " << error << std::endl;
+        return 1;
+    }
+    stream << "  Invariants held." << std::endl;
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+void runBenchmarks(std::ostream& stream);
+void benchmarkVertexTransforms(std::ostream& stream);
+void benchmarkParallelRebuild(std::ostream& stream);
+void benchmarkTilingFile(std::ostream& stream);
+int runStressTest(std::ostream& stream,
+                  const std::vector<std::string>& arguments);
+
+#endif /* BENCHMARK_H */
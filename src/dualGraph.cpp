@@ -0,0 +1,75 @@
+#include "dualGraph.h"
+#include <cstdint>
+
+/// @brief Build the arrays: offsets in a single pass over the nodes of
+/// `graph`, then the other arrays for ranges of nodes in parallel.
+/// @param graph
+/// @param polygons polygons indexed by id
+/// @param pool
+DualGraph::DualGraph(const AdjacencyGraph& graph,
+                     const std::vector<std::shared_ptr<Polygon>>& polygons,
+                     ThreadPool& pool)
+    : offsets(graph.size() + 1, 0), neighbors(2 * graph.getEdgeCount()),
+      sharedEdges(2 * graph.getEdgeCount()), nbSides(graph.size()),
+      colors(graph.size()) {
+    for (int node = 0; node < graph.size(); node++) {
+        offsets[node + 1] = offsets[node] + graph.getNeighbors(node).size();
+    }
+    pool.parallelFor(0, graph.size(), [&](int begin, int end) {
+        for (int node = begin; node < end; node++) {
+            int entry = offsets[node];
+            for (auto& neighbor : graph.getNeighbors(node)) {
+                neighbors[entry] = neighbor.polygon;
+                sharedEdges[entry] = neighbor.edge;
+                entry++;
+            }
+            nbSides[node] = polygons[node]->nbSides;
+            colors[node] = polygons[node]->getColorIndex();
+        }
+    });
+}
+
+/// @brief Number of nodes.
+int DualGraph::size() const { return nbSides.size(); }
+
+static void writeArray(std::ostream& stream, const std::vector<int>& array) {
+    static_assert(sizeof(int) == sizeof(std::int32_t), "int should be 32 bit");
+    stream.write(reinterpret_cast<const char*>(array.data()),
+                 array.size() * sizeof(int));
+}
+
+/// @brief Write the graph as the "TDG1" magic number, the number of nodes and
+/// the number of neighbor entries followed by arrays `offsets`, `neighbors`,
+/// `sharedEdges`, `nbSides` and `colors`. All values are 32-bit integers in
+/// the byte order of the machine.
+void DualGraph::writeBinary(std::ostream& stream) const {
+    stream.write("TDG1", 4);
+    std::int32_t header[2] = {size(),
+                              static_cast<std::int32_t>(neighbors.size())};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(stream, offsets);
+    writeArray(stream, neighbors);
+    writeArray(stream, sharedEdges);
+    writeArray(stream, nbSides);
+    writeArray(stream, colors);
+}
+
+static void writeLine(std::ostream& stream, const char* name,
+                      const std::vector<int>& array) {
+    stream << name;
+    for (int value : array) {
+        stream << ' ' << value;
+    }
+    stream << '\n';
+}
+
+/// @brief Write the graph as one line per array, each line starting with the
+/// name of the array.
+void DualGraph::writeText(std::ostream& stream) const {
+    stream << "nodes " << size() << '\n';
+    writeLine(stream, "offsets", offsets);
+    writeLine(stream, "neighbors", neighbors);
+    writeLine(stream, "sharedEdges", sharedEdges);
+    writeLine(stream, "nbSides", nbSides);
+    writeLine(stream, "colors", colors);
+}
@@ -0,0 +1,31 @@
+#ifndef DUAL_GRAPH_H
+#define DUAL_GRAPH_H
+
+#include "adjacencyGraph.h"
+#include "polygon.h"
+#include "threadPool.h"
+#include <memory>
+#include <ostream>
+#include <vector>
+
+/// @brief Dual graph of a tiling in compressed sparse row format.
+///
+/// The neighbors of node `n` are `neighbors[offsets[n]]` to
+/// `neighbors[offsets[n + 1] - 1]`, and `sharedEdges` holds, for each of
+/// them, the side of polygon `n` they share.
+struct DualGraph {
+    std::vector<int> offsets{};
+    std::vector<int> neighbors{};
+    std::vector<int> sharedEdges{};
+    std::vector<int> nbSides{};
+    std::vector<int> colors{};
+
+    DualGraph(const AdjacencyGraph& graph,
+              const std::vector<std::shared_ptr<Polygon>>& polygons,
+              ThreadPool& pool);
+    int size() const;
+    void writeBinary(std::ostream& stream) const;
+    void writeText(std::ostream& stream) const;
+};
+
+#endif /* DUAL_GRAPH_H */
@@ -1,27 +1,25 @@
 #include "edge.h"
+#include "utils.h"
+#include "worldGeometry.h"
 #include <glm/glm.hpp>
-#include <iostream>
 
-void Edge::highlight(const unsigned shaderProgram) const {
-    polygon->highlightEdge(shaderProgram, edge);
-}
-
-void Edge::underline(const unsigned shaderProgram) const {
-    polygon->underlineEdge(shaderProgram, edge);
-}
-
-bool Edge::connectedTo(const Edge& other) const {
-    glm::vec2 other_a = other.polygon->getVertex(other.edge);
-    glm::vec2 other_b = other.polygon->getVertex(other.edge + 1);
-    glm::vec2 this_a = polygon->getVertex(edge);
-    glm::vec2 this_b = polygon->getVertex(edge + 1);
-    float distance1 = glm::distance(other_a, this_b);
-    float distance2 = glm::distance(other_b, this_a);
-    std::clog << distance1 << ", " << distance2 << std::endl;
-    return (distance1 < 1e-3) && (distance2 < 1e-3);
+/// @brief Whether this side and `other` are the same segment in opposite
+/// directions, i.e. shared by their polygons.
+/// @param other
+/// @param geometry holds the vertices of both polygons
+bool Edge::connectedTo(const Edge& other,
+                       const WorldGeometry& geometry) const {
+    const int id = polygon->getId(), otherId = other.polygon->getId();
+    double distance1 = glm::distance(geometry.getVertex(otherId, other.edge),
+                                     geometry.getVertex(id, edge + 1));
+    double distance2 =
+        glm::distance(geometry.getVertex(otherId, other.edge + 1),
+                      geometry.getVertex(id, edge));
+    return (distance1 < DISTANCE_THRESHOLD) &&
+           (distance2 < DISTANCE_THRESHOLD);
 };
 
-glm::vec2 Edge::getFirstVertex() const { return polygon->getVertex(edge); }
+glm::dvec2 Edge::getFirstVertex() const { return polygon->getVertex(edge); }
 
 std::size_t EdgeHash::operator()(const Edge& e) const {
     std::string text =
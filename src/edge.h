@@ -5,6 +5,8 @@
 #include <glm/vec2.hpp>
 #include <string>
 
+class WorldGeometry;
+
 /// @brief Side of a Polygon.
 struct Edge {
     std::shared_ptr<Polygon> polygon{};
@@ -12,10 +14,8 @@ struct Edge {
 
     Edge(std::shared_ptr<Polygon> polygon, int edge)
         : polygon(polygon), edge(edge) {};
-    void highlight(const unsigned shaderProgram) const;
-    void underline(const unsigned shaderProgram) const;
-    bool connectedTo(const Edge& edge) const;
-    glm::vec2 getFirstVertex() const;
+    bool connectedTo(const Edge& edge, const WorldGeometry& geometry) const;
+    glm::dvec2 getFirstVertex() const;
 };
 
 struct EdgeHash {
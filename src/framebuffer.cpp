@@ -0,0 +1,67 @@
+#include "framebuffer.h"
+#include <algorithm>
+#include <glad/glad.h>
+
+Framebuffer::Framebuffer(const int width, const int height)
+    : width(width), height(height) {
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, colorBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer() {
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
+
+/// @brief Whether the driver can draw into the framebuffer, which may fail
+/// for sizes above `GL_MAX_RENDERBUFFER_SIZE`.
+bool Framebuffer::isComplete() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    bool complete =
+        glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+/// @brief Draw into the framebuffer instead of the default one.
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void Framebuffer::unbind() const { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+/// @brief Read the lower left `width` x `height` pixels of the drawn image,
+/// where a viewport smaller than the framebuffer was drawn.
+/// @param width at most the width of the framebuffer
+/// @param height at most the height of the framebuffer
+/// @param rgb replaced by `3 * width * height` bytes, the top row first
+void Framebuffer::readPixels(const int width, const int height,
+                             std::vector<unsigned char>& rgb) const {
+    std::vector<unsigned char> rgba(4 * width * height);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    rgb.resize(3 * width * height);
+    // OpenGL stores the bottom row first
+    for (int y = 0; y < height; y++) {
+        const unsigned char* source = &rgba[4 * width * (height - 1 - y)];
+        unsigned char* destination = &rgb[3 * width * y];
+        for (int x = 0; x < width; x++) {
+            std::copy(source + 4 * x, source + 4 * x + 3,
+                      destination + 3 * x);
+        }
+    }
+}
+
+/// @brief Read the whole drawn image.
+/// @param rgb replaced by `3 * width * height` bytes, the top row first
+void Framebuffer::readPixels(std::vector<unsigned char>& rgb) const {
+    readPixels(width, height, rgb);
+}
@@ -0,0 +1,29 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <vector>
+
+/// @brief Framebuffer object with an RGBA color renderbuffer, drawn into
+/// instead of a window. Non-copyable.
+/// Must be created, used and destroyed on the thread owning the OpenGL
+/// context.
+class Framebuffer {
+    unsigned framebuffer{};
+    unsigned colorBuffer{};
+    int width{};
+    int height{};
+
+  public:
+    Framebuffer(const int width, const int height);
+    ~Framebuffer();
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+    bool isComplete() const;
+    void bind() const;
+    void unbind() const;
+    void readPixels(const int width, const int height,
+                    std::vector<unsigned char>& rgb) const;
+    void readPixels(std::vector<unsigned char>& rgb) const;
+};
+
+#endif /* FRAMEBUFFER_H */
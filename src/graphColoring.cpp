@@ -0,0 +1,149 @@
+#include "graphColoring.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <tuple>
+
+// radius of the region recolored when a polygon has no free color
+static const int RECOLORING_RADIUS = 2;
+
+/// @brief Bitmask of the colors used by the colored neighbors of `polygon`.
+static std::uint32_t neighborMask(const AdjacencyGraph& graph,
+                                  const std::vector<int>& colors,
+                                  const int polygon) {
+    std::uint32_t mask = 0;
+    for (auto& neighbor : graph.getNeighbors(polygon)) {
+        if (colors[neighbor.polygon] >= 0) {
+            mask |= 1u << colors[neighbor.polygon];
+        }
+    }
+    return mask;
+}
+
+/// @brief Smallest color absent from `mask`, or -1 if all colors are used.
+static int smallestFreeColor(const std::uint32_t mask) {
+    std::uint32_t freeColors = ~mask & ((1u << NB_COLORS) - 1);
+    return freeColors ? __builtin_ctz(freeColors) : -1;
+}
+
+/// @brief Color the nodes with color -1 in `colors` using DSatur: the node
+/// whose neighbors use the most distinct colors is colored first (ties go to
+/// the node with the most neighbors), with the smallest free color.
+/// @return false if some node had no free color (it is then given color 0)
+static bool dsatur(const AdjacencyGraph& graph, std::vector<int>& colors,
+                   const std::vector<int>& nodes) {
+    bool proper = true;
+    // (saturation, degree, node), the greatest is colored first
+    std::set<std::tuple<int, int, int>> queue{};
+    std::vector<std::uint32_t> masks(colors.size(), 0);
+    for (int node : nodes) {
+        masks[node] = neighborMask(graph, colors, node);
+        queue.emplace(__builtin_popcount(masks[node]),
+                      graph.getNeighbors(node).size(), node);
+    }
+    while (!queue.empty()) {
+        auto first = std::prev(queue.end());
+        int node = std::get<2>(*first);
+        queue.erase(first);
+        int color = smallestFreeColor(masks[node]);
+        if (color < 0) {
+            proper = false;
+            color = 0;
+        }
+        colors[node] = color;
+        for (auto& neighbor : graph.getNeighbors(node)) {
+            int other = neighbor.polygon;
+            if (colors[other] >= 0 || (masks[other] & (1u << color))) {
+                continue;
+            }
+            int degree = graph.getNeighbors(other).size();
+            queue.erase(std::make_tuple(__builtin_popcount(masks[other]),
+                                        degree, other));
+            masks[other] |= 1u << color;
+            queue.emplace(__builtin_popcount(masks[other]), degree, other);
+        }
+    }
+    return proper;
+}
+
+static std::vector<int>
+colorsOf(const std::vector<std::shared_ptr<Polygon>>& polygons) {
+    std::vector<int> colors(polygons.size());
+    for (std::size_t n = 0; n < polygons.size(); n++) {
+        colors[n] = polygons[n]->getColorIndex();
+    }
+    return colors;
+}
+
+/// @brief Give `polygon` the smallest color unused by its neighbors, which
+/// costs O(degree).
+///
+/// When all colors are taken, the polygons at distance at most
+/// `RECOLORING_RADIUS` of `polygon` are recolored with DSatur, the polygons
+/// around them keeping their colors.
+/// @param graph
+/// @param polygons polygons indexed by id
+/// @param polygon id of the polygon to color
+/// @return the smallest id of the polygons whose color was set
+int colorPolygon(const AdjacencyGraph& graph,
+                 std::vector<std::shared_ptr<Polygon>>& polygons,
+                 const int polygon) {
+    std::uint32_t mask = 0;
+    for (auto& neighbor : graph.getNeighbors(polygon)) {
+        mask |= 1u << polygons[neighbor.polygon]->getColorIndex();
+    }
+    int color = smallestFreeColor(mask);
+    if (color >= 0) {
+        polygons[polygon]->setColor(static_cast<PolygonColor>(color));
+        return polygon;
+    }
+
+    auto colors = colorsOf(polygons);
+    std::vector<int> region{polygon};
+    colors[polygon] = -1;
+    // breadth-first search, `colors` marks the visited polygons
+    std::size_t begin = 0;
+    for (int depth = 0; depth < RECOLORING_RADIUS; depth++) {
+        std::size_t end = region.size();
+        for (std::size_t n = begin; n < end; n++) {
+            for (auto& neighbor : graph.getNeighbors(region[n])) {
+                if (colors[neighbor.polygon] >= 0) {
+                    colors[neighbor.polygon] = -1;
+                    region.push_back(neighbor.polygon);
+                }
+            }
+        }
+        begin = end;
+    }
+    if (!dsatur(graph, colors, region)) {
+        logError("No proper coloring found around the new polygon.");
+    }
+    for (int node : region) {
+        polygons[node]->setColor(static_cast<PolygonColor>(colors[node]));
+    }
+    return *std::min_element(region.begin(), region.end());
+}
+
+/// @brief Recolor all polygons with DSatur, which tends to use few colors.
+/// @param graph
+/// @param polygons polygons indexed by id
+/// @return the number of colors used
+int recolorPolygons(const AdjacencyGraph& graph,
+                    std::vector<std::shared_ptr<Polygon>>& polygons) {
+    std::vector<int> colors(polygons.size(), -1);
+    std::vector<int> nodes(polygons.size());
+    for (std::size_t n = 0; n < nodes.size(); n++) {
+        nodes[n] = n;
+    }
+    if (!dsatur(graph, colors, nodes)) {
+        logError("No proper coloring found.");
+    }
+    int nbColors = 0;
+    for (std::size_t n = 0; n < polygons.size(); n++) {
+        polygons[n]->setColor(static_cast<PolygonColor>(colors[n]));
+        nbColors = std::max(nbColors, colors[n] + 1);
+    }
+    return nbColors;
+}
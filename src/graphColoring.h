@@ -0,0 +1,15 @@
+#ifndef GRAPH_COLORING_H
+#define GRAPH_COLORING_H
+
+#include "adjacencyGraph.h"
+#include "polygon.h"
+#include <memory>
+#include <vector>
+
+int colorPolygon(const AdjacencyGraph& graph,
+                 std::vector<std::shared_ptr<Polygon>>& polygons,
+                 const int polygon);
+int recolorPolygons(const AdjacencyGraph& graph,
+                    std::vector<std::shared_ptr<Polygon>>& polygons);
+
+#endif /* GRAPH_COLORING_H */
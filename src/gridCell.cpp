@@ -0,0 +1,21 @@
+#include "gridCell.h"
+#include <cmath>
+#include <functional>
+
+/// @brief Cell of size `cellSize` containing `point`.
+/// @param point
+/// @param cellSize
+GridCell::GridCell(const glm::dvec2& point, const double cellSize)
+    : x(static_cast<long long>(std::floor(point.x / cellSize))),
+      y(static_cast<long long>(std::floor(point.y / cellSize))) {}
+
+std::size_t GridCellHash::operator()(const GridCell& cell) const {
+    // mix both coordinates so that neighboring cells land in distinct buckets
+    std::size_t hash = std::hash<long long>()(cell.x);
+    return hash ^ (std::hash<long long>()(cell.y) + 0x9e3779b97f4a7c15ULL +
+                   (hash << 6) + (hash >> 2));
+}
+
+bool operator==(const GridCell& lhs, const GridCell& rhs) {
+    return lhs.x == rhs.x && lhs.y == rhs.y;
+}
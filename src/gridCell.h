@@ -0,0 +1,22 @@
+#ifndef GRID_CELL_H
+#define GRID_CELL_H
+
+#include <cstddef>
+#include <glm/vec2.hpp>
+
+/// @brief Cell of a uniform grid covering the plane, used to hash positions.
+struct GridCell {
+    long long x{};
+    long long y{};
+
+    GridCell(long long x, long long y) : x(x), y(y) {};
+    GridCell(const glm::dvec2& point, const double cellSize);
+};
+
+struct GridCellHash {
+    std::size_t operator()(const GridCell& cell) const;
+};
+
+bool operator==(const GridCell& lhs, const GridCell& rhs);
+
+#endif /* GRID_CELL_H */
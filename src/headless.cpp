@@ -0,0 +1,235 @@
+#include "headless.h"
+#include "headlessContext.h"
+#include "hyperbolicTiling.h"
+#include "imageExport.h"
+#include "periodicTiling.h"
+#include "renderer.h"
+#include "scene.h"
+#include "substitutionTiling.h"
+#include "threadPool.h"
+#include "tiling.h"
+#include "tilingFile.h"
+#include "utils.h"
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <thread>
+
+static const char* USAGE =
+    "Usage: main --render [options] FILE.png [[options] FILE.png...]\n"
+    "Options apply to the images named after them:\n"
+    "  --size WIDTHxHEIGHT      image size in pixels\n"
+    "  --zoom STEPS             zoom in (or out if negative) by 2^STEPS\n"
+    "  --tiling FILE            tiling saved with S\n"
+    "  --periodic NAME          Archimedean tiling, e.g. 4.8.8 (default)\n"
+    "  --penrose                Penrose rhomb tiling\n"
+    "  --ammann-beenker         Ammann-Beenker tiling\n"
+    "  --hyperbolic P Q         hyperbolic tiling {P, Q}\n"
+    "  --depth DEPTH            substitutions or hyperbolic layers\n";
+
+/// @brief What the next images show.
+enum class Content { tiling, periodic, patch, hyperbolic };
+
+/// @brief Preset of `PeriodicTiling` named `name`, -1 if there is none.
+static int findPreset(PeriodicTiling& periodic, const std::string& name) {
+    const int current = periodic.getPreset();
+    int found = -1;
+    for (int preset = 0; preset < PeriodicTiling::getNbPresets(); preset++) {
+        periodic.setPreset(preset);
+        if (periodic.getName() == name) {
+            found = preset;
+        }
+    }
+    periodic.setPreset(current);
+    return found;
+}
+
+/// @brief Read the whole of `text` as a decimal int.
+/// @return whether it is one, `value` is unchanged otherwise
+static bool parseInt(const std::string& text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end || errno == ERANGE || parsed < INT_MIN ||
+        parsed > INT_MAX) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/// @brief Replace `tiling` by the tiling saved in `filename`.
+/// @return whether the whole file was read
+static bool loadTiling(Tiling& tiling, const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        logError("Failed to open the tiling file.");
+        return false;
+    }
+    tiling.removeAllPolygons();
+    TilingReader reader(file);
+    TilingRecord record{};
+    while (reader.next(record)) {
+        tiling.load(record);
+    }
+    return !reader.hasFailed();
+}
+
+/// @brief Render images without a window nor display server, e.g. on
+/// CPU-only servers through Mesa's llvmpipe.
+///
+/// Arguments are read in order: options change what the following images
+/// show, and any other argument is the name of a PNG file rendered with the
+/// current options. Many images are rendered with a single OpenGL context.
+/// @param arguments command line arguments after `--render`
+/// @return exit code
+int runHeadless(const std::vector<std::string>& arguments) {
+    HeadlessContext context{};
+    if (!context.isValid()) {
+        return 1;
+    }
+    glClearColor(1.0, 1.0, 1.0, 1.0);
+    Renderer renderer{(GLADloadproc)eglGetProcAddress};
+    ThreadPool pool{};
+    PeriodicTiling periodic{[]() {}};
+    Tiling tiling{};
+    SubstitutionTiling patch{};
+    HyperbolicTiling hyperbolic{};
+    Content content = Content::periodic;
+    Scene scene{};
+    View view{};
+    view.interactive = false;
+    view.resize(DEFAULT_WINDOW_SIZE, DEFAULT_WINDOW_SIZE);
+    int zoom = 0;
+    int failures = 0;
+
+    for (std::size_t n = 0; n < arguments.size(); n++) {
+        const std::string& argument = arguments[n];
+        // number of values following the option
+        const int nbValues = argument == "--hyperbolic" ? 2
+                             : argument == "--size" ||
+                                     argument == "--zoom" ||
+                                     argument == "--periodic" ||
+                                     argument == "--tiling" ||
+                                     argument == "--depth"
+                                 ? 1
+                                 : 0;
+        if (n + nbValues >= arguments.size()) {
+            std::cerr << USAGE;
+            return 1;
+        }
+        if (argument == "--size") {
+            int width = 0, height = 0;
+            int count = std::sscanf(arguments[++n].c_str(), "%dx%d", &width,
+                                    &height);
+            if (count == 1) {
+                height = width;
+            }
+            if (count < 1 || width <= 0 || height <= 0) {
+                logError("Invalid image size.");
+                return 1;
+            }
+            view.resize(width, height);
+        } else if (argument == "--zoom") {
+            if (!parseInt(arguments[++n], zoom)) {
+                logError("Invalid zoom.");
+                std::cerr << USAGE;
+                return 1;
+            }
+        } else if (argument == "--tiling") {
+            if (!loadTiling(tiling, arguments[++n])) {
+                return 1;
+            }
+            content = Content::tiling;
+        } else if (argument == "--periodic") {
+            int preset = findPreset(periodic, arguments[++n]);
+            if (preset < 0) {
+                logError("Unknown periodic tiling.");
+                return 1;
+            }
+            content = Content::periodic;
+            periodic.setPreset(preset);
+        } else if (argument == "--penrose") {
+            content = Content::patch;
+            patch.setSubstitution(Substitution::penrose);
+        } else if (argument == "--ammann-beenker") {
+            content = Content::patch;
+            patch.setSubstitution(Substitution::ammannBeenker);
+        } else if (argument == "--hyperbolic") {
+            int p = 0, q = 0;
+            if (!parseInt(arguments[n + 1], p) ||
+                !parseInt(arguments[n + 2], q) || p < 3 || q < 3) {
+                logError("Invalid hyperbolic tiling.");
+                std::cerr << USAGE;
+                return 1;
+            }
+            n += 2;
+            if (!HyperbolicTiling::isHyperbolic(p, q)) {
+                logError("{p, q} isn't a hyperbolic tiling.");
+                return 1;
+            }
+            content = Content::hyperbolic;
+            hyperbolic.setSymbol(p, q);
+        } else if (argument == "--depth") {
+            int depth = 0;
+            if (!parseInt(arguments[++n], depth)) {
+                logError("Invalid depth.");
+                std::cerr << USAGE;
+                return 1;
+            }
+            patch.setDepth(depth);
+            hyperbolic.setDepth(depth);
+        } else if (argument.compare(0, 2, "--") == 0) {
+            std::cerr << USAGE;
+            return 1;
+        } else {
+            view.viewMatrix =
+                glm::mat3x2(std::pow(2.0f, static_cast<float>(zoom)));
+            glm::dvec2 min{}, max{};
+            view.getVisibleBounds(min, max);
+            switch (content) {
+                case Content::tiling:
+                    scene.capture(tiling, view.origin);
+                    break;
+                case Content::periodic:
+                    // chunks are generated on `pool`
+                    periodic.update(min, max, pool);
+                    while (periodic.hasPendingChunks()) {
+                        std::this_thread::sleep_for(
+                            std::chrono::milliseconds(1));
+                        periodic.update(min, max, pool);
+                    }
+                    scene.capture(periodic, view.origin);
+                    break;
+                case Content::patch:
+                    if (!patch.covers(min, max)) {
+                        patch.generate(min, max, pool);
+                    }
+                    scene.capture(patch, view.origin);
+                    break;
+                case Content::hyperbolic:
+                    if (!hyperbolic.covers(view.getPixelSize())) {
+                        hyperbolic.generate(view.getPixelSize());
+                    }
+                    scene.capture(hyperbolic);
+                    break;
+            }
+            scene.version++;
+            if (!renderToPng(renderer, scene, view, argument)) {
+                failures++;
+            }
+        }
+    }
+    if (arguments.empty()) {
+        std::cerr << USAGE;
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
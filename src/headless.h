@@ -0,0 +1,9 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <string>
+#include <vector>
+
+int runHeadless(const std::vector<std::string>& arguments);
+
+#endif /* HEADLESS_H */
@@ -0,0 +1,118 @@
+#include "headlessContext.h"
+#include "utils.h"
+#include <EGL/eglext.h>
+#include <cstring>
+#include <glad/glad.h>
+#include <iostream>
+
+/// @brief Whether the space-separated `extensions` contain `extension`.
+static bool hasExtension(const char* extensions, const char* extension) {
+    if (!extensions) {
+        return false;
+    }
+    const std::size_t length = std::strlen(extension);
+    for (const char* start = std::strstr(extensions, extension); start;
+         start = std::strstr(start + length, extension)) {
+        bool first = start == extensions || start[-1] == ' ';
+        bool last = start[length] == ' ' || start[length] == '\0';
+        if (first && last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+HeadlessContext::HeadlessContext() {
+    // the surfaceless platform needs neither X11 nor Wayland
+    auto getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay &&
+        hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS),
+                     "EGL_MESA_platform_surfaceless")) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                     EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint major{}, minor{};
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        logError("Failed to initialize EGL");
+        display = EGL_NO_DISPLAY;
+        return;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        logError("EGL doesn't support desktop OpenGL");
+        return;
+    }
+
+    const bool surfaceless = hasExtension(
+        eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8, EGL_NONE};
+    EGLConfig config{};
+    EGLint nbConfigs{};
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &nbConfigs) ||
+        nbConfigs == 0) {
+        logError("No EGL configuration supports OpenGL");
+        return;
+    }
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    context =
+        eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        logError("Failed to create an OpenGL 3.3 context with EGL");
+        return;
+    }
+    if (!surfaceless) {
+        const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1,
+                                            EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if (surface == EGL_NO_SURFACE) {
+            logError("Failed to create an EGL pbuffer");
+            return;
+        }
+    }
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        logError("Failed to make the EGL context current");
+        return;
+    }
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        logError("Failed to load GLAD");
+        return;
+    }
+    valid = true;
+    std::clog << "EGL " << major << "." << minor << ", "
+              << glGetString(GL_RENDERER) << std::endl;
+    log(" was " GREEN "created" RESET ".");
+}
+
+HeadlessContext::~HeadlessContext() {
+    if (display == EGL_NO_DISPLAY) {
+        return;
+    }
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+    if (context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+    }
+    eglTerminate(display);
+    if (valid) {
+        log(" was " RED "deleted" RESET ".");
+    }
+}
+
+/// @brief Whether the context is current and OpenGL functions are loaded.
+bool HeadlessContext::isValid() const { return valid; }
+
+void HeadlessContext::log(const char* log) const {
+    std::clog << "HeadlessContext" << log << std::endl;
+}
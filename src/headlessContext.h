@@ -0,0 +1,29 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <EGL/egl.h>
+
+/// @brief OpenGL 3.3 core context without any window nor display server,
+/// created through EGL (e.g. by Mesa's llvmpipe on CPU-only machines).
+/// Non-copyable.
+///
+/// The context is made current on the creating thread and OpenGL functions
+/// are loaded. It has no surface when the driver supports surfaceless
+/// contexts, and a 1x1 pbuffer otherwise: drawing goes to a Framebuffer.
+class HeadlessContext {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    EGLSurface surface = EGL_NO_SURFACE;
+    bool valid = false;
+
+    void log(const char* log) const;
+
+  public:
+    HeadlessContext();
+    ~HeadlessContext();
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+    bool isValid() const;
+};
+
+#endif /* HEADLESS_CONTEXT_H */
@@ -0,0 +1,213 @@
+#include "hyperbolicTiling.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+typedef std::complex<double> complex;
+
+// bounds the tiles of deep tilings seen from far away
+static const std::size_t MAX_TILES = 1 << 18;
+static const int MAX_DEPTH = 64;
+
+/// @brief Coefficients of the composition of the Möbius transformations
+/// (a1, b1) then (a2, b2), applied right to left.
+static void compose(const complex& a1, const complex& b1, const complex& a2,
+                    const complex& b2, complex& a, complex& b) {
+    a = a1 * a2 + b1 * std::conj(b2);
+    b = a1 * b2 + b1 * std::conj(a2);
+    // keeps |a|^2 - |b|^2 = 1 despite rounding
+    double scale = std::sqrt(std::norm(a) - std::norm(b));
+    a /= scale;
+    b /= scale;
+}
+
+/// @brief Euclidean distance to the center of the disk of the point at
+/// hyperbolic distance acosh(coshDistance) from it.
+static double diskDistance(const double coshDistance) {
+    return std::sqrt((coshDistance - 1.0) / (coshDistance + 1.0));
+}
+
+/// @brief Whether {p, q} tiles the hyperbolic plane rather than the sphere or
+/// the Euclidean plane.
+bool HyperbolicTiling::isHyperbolic(const int p, const int q) {
+    return (p - 2) * (q - 2) > 4;
+}
+
+/// @brief Use `q` p-gons around each vertex, if {p, q} is hyperbolic.
+void HyperbolicTiling::setSymbol(const int p, const int q) {
+    if (!isHyperbolic(p, q)) {
+        logError("{p, q} isn't a hyperbolic tiling.");
+        return;
+    }
+    if (p != this->p || q != this->q) {
+        this->p = p;
+        this->q = q;
+        generated = false;
+    }
+}
+
+int HyperbolicTiling::getP() const { return p; }
+
+int HyperbolicTiling::getQ() const { return q; }
+
+/// @brief Set the number of layers around the central tile, between 0 and
+/// `MAX_DEPTH`.
+void HyperbolicTiling::setDepth(const int depth) {
+    int clamped = std::max(0, std::min(depth, MAX_DEPTH));
+    if (clamped != this->depth) {
+        this->depth = clamped;
+        generated = false;
+    }
+}
+
+int HyperbolicTiling::getDepth() const { return depth; }
+
+/// @brief Whether the tiles were generated with this symbol, depth and
+/// `minSize`.
+bool HyperbolicTiling::covers(const double minSize) const {
+    return generated && minSize == this->minSize;
+}
+
+/// @brief Replace the tiles by the first `depth` layers around the central
+/// tile, not expanding tiles smaller than `minSize`, then color them.
+/// @param minSize usually the size of a pixel, in disk units
+void HyperbolicTiling::generate(const double minSize) {
+    const double pi = glm::pi<double>();
+    radius = diskDistance(1.0 / (std::tan(pi / p) * std::tan(pi / q)));
+    // the midpoint of side 0 is on the positive x axis
+    const double midpoint =
+        diskDistance(std::cos(pi / q) / std::sin(pi / p));
+
+    // half-turn around the midpoint of side 0, which swaps its vertices
+    const double scale = 1.0 / std::sqrt(1.0 - midpoint * midpoint);
+    complex a{}, b{}, halfTurnA{}, halfTurnB{};
+    compose(complex(0.0, 1.0), 0.0, scale, -midpoint * scale, a, b);
+    compose(scale, midpoint * scale, a, b, halfTurnA, halfTurnB);
+    steps.clear();
+    for (int side = 0; side < p; side++) {
+        // rotation by side * 2 pi / p around the center
+        complex rotation = std::polar(1.0, side * pi / p);
+        compose(rotation, 0.0, halfTurnA, halfTurnB, a, b);
+        steps.push_back(a);
+        steps.push_back(b);
+    }
+
+    tiles.clear();
+    neighbors.clear();
+    tiles.emplace_back(1.0, 0.0, 0);
+    neighbors.resize(p, -1);
+    for (std::size_t tile = 0; tile < tiles.size(); tile++) {
+        const HyperbolicTile& current = tiles[tile];
+        if (current.layer >= depth ||
+            2.0 * radius / std::norm(current.a) < minSize) {
+            continue;
+        }
+        for (int vertex = 0; vertex < p && tiles.size() < MAX_TILES;
+             vertex++) {
+            completeVertex(tile, vertex);
+        }
+    }
+    colorTiles();
+    this->minSize = minSize;
+    generated = true;
+}
+
+/// @brief Add the tile across side `side` of `tile`.
+/// @return the new tile
+int HyperbolicTiling::addNeighbor(const int tile, const int side) {
+    complex a{}, b{};
+    compose(tiles[tile].a, tiles[tile].b, steps[2 * side],
+            steps[2 * side + 1], a, b);
+    const int neighbor = tiles.size();
+    tiles.emplace_back(a, b, tiles[tile].layer + 1);
+    neighbors.resize(neighbors.size() + p, -1);
+    connect(tile * p + side, neighbor * p);
+    return neighbor;
+}
+
+/// @brief Make two sides neighbors, unless either has another neighbor.
+/// @param side `tile * p + side`
+/// @param other
+/// @return whether the sides are neighbors
+bool HyperbolicTiling::connect(const int side, const int other) {
+    if (neighbors[side] == other && neighbors[other] == side) {
+        return true;
+    }
+    if (neighbors[side] >= 0 || neighbors[other] >= 0) {
+        logError("Hyperbolic tiles have inconsistent neighbors.");
+        return false;
+    }
+    neighbors[side] = other;
+    neighbors[other] = side;
+    return true;
+}
+
+/// @brief Add the missing tiles of the ring of `q` tiles around a vertex.
+///
+/// Known tiles form an arc of the ring: it is walked from `tile` both ways,
+/// across the side starting at the vertex then across the side ending at
+/// it, and the remaining tiles are added after its counter-clockwise end.
+/// Vertex n of a tile is the start of side n, and sides shared by two tiles
+/// are reversed from one to the other.
+void HyperbolicTiling::completeVertex(const int tile, const int vertex) {
+    int count = 1;
+    int last = tile, lastVertex = vertex;
+    while (count < q && neighbors[last * p + lastVertex] >= 0) {
+        int next = neighbors[last * p + lastVertex];
+        last = next / p;
+        lastVertex = (next % p + 1) % p;
+        count++;
+    }
+    int first = tile, firstVertex = vertex;
+    while (count < q &&
+           neighbors[first * p + (firstVertex + p - 1) % p] >= 0) {
+        int next = neighbors[first * p + (firstVertex + p - 1) % p];
+        first = next / p;
+        firstVertex = next % p;
+        count++;
+    }
+    for (; count < q; count++) {
+        last = addNeighbor(last, lastVertex);
+        lastVertex = 1;
+    }
+    connect(last * p + lastVertex, first * p + (firstVertex + p - 1) % p);
+}
+
+/// @brief Give each tile the smallest color not used by the neighbors
+/// colored before it.
+void HyperbolicTiling::colorTiles() {
+    for (std::size_t tile = 0; tile < tiles.size(); tile++) {
+        unsigned used = 0;
+        for (int side = 0; side < p; side++) {
+            int neighbor = neighbors[tile * p + side] / p;
+            if (neighbors[tile * p + side] >= 0 &&
+                static_cast<std::size_t>(neighbor) < tile) {
+                used |= 1u << tiles[neighbor].color;
+            }
+        }
+        int color = 0;
+        while (used & (1u << color)) {
+            color++;
+        }
+        tiles[tile].color = color;
+    }
+}
+
+double HyperbolicTiling::getRadius() const { return radius; }
+
+const std::vector<HyperbolicTile>& HyperbolicTiling::getTiles() const {
+    return tiles;
+}
+
+const std::vector<int>& HyperbolicTiling::getNeighbors() const {
+    return neighbors;
+}
+
+/// @brief Position of vertex `vertex` of `tile` in the disk.
+std::complex<double> HyperbolicTiling::getVertex(const HyperbolicTile& tile,
+                                                 const int vertex) const {
+    const double pi = glm::pi<double>();
+    complex z = std::polar(radius, (2.0 * vertex - 1.0) * pi / p);
+    return (tile.a * z + tile.b) / (std::conj(tile.b) * z + std::conj(tile.a));
+}
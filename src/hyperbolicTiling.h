@@ -0,0 +1,71 @@
+#ifndef HYPERBOLIC_TILING_H
+#define HYPERBOLIC_TILING_H
+
+#include <complex>
+#include <vector>
+
+// points per side of the outline of hyperbolic tiles, as in the vertex shader
+const int HYPERBOLIC_SUBDIVISIONS = 8;
+
+/// @brief Tile of a hyperbolic tiling: the image of the central tile by the
+/// Möbius transformation z -> (a z + b) / (conj(b) z + conj(a)) of the
+/// Poincaré disk, with |a|^2 - |b|^2 = 1.
+/// Side 0 is shared with the tile it was generated from.
+struct HyperbolicTile {
+    std::complex<double> a{1.0};
+    std::complex<double> b{};
+    // number of tiles between this one and the central tile
+    int layer{};
+    int color{};
+    HyperbolicTile(const std::complex<double>& a, const std::complex<double>& b,
+                   const int layer)
+        : a(a), b(b), layer(layer) {};
+};
+
+/// @brief Regular tiling {p, q} of the hyperbolic plane in the Poincaré disk
+/// of radius 1, with `q` p-gons around each vertex.
+///
+/// Tiles are generated breadth first from the central tile, `depth` layers
+/// deep. A tile is generated by completing the ring of `q` tiles around one
+/// of its vertices: the relation of the symmetry group around a vertex,
+/// rather than floating point positions, tells which neighbors exist
+/// already, so that every tile is generated once. Tiles smaller than
+/// `minSize` aren't expanded, which bounds their number near the circle.
+class HyperbolicTiling {
+    int p = 7;
+    int q = 3;
+    int depth = 12;
+    double minSize{};
+    bool generated = false;
+    // Euclidean distance between the center and the vertices of a tile
+    double radius{};
+    std::vector<HyperbolicTile> tiles{};
+    // side `side` of tile `tile` at `tile * p + side`: the neighbor tile and
+    // side encoded the same way, or -1
+    std::vector<int> neighbors{};
+    // coefficients a then b of the transformations moving the central tile
+    // onto its neighbor across each side
+    std::vector<std::complex<double>> steps{};
+
+    int addNeighbor(const int tile, const int side);
+    bool connect(const int side, const int other);
+    void completeVertex(const int tile, const int vertex);
+    void colorTiles();
+
+  public:
+    static bool isHyperbolic(const int p, const int q);
+    void setSymbol(const int p, const int q);
+    int getP() const;
+    int getQ() const;
+    void setDepth(const int depth);
+    int getDepth() const;
+    bool covers(const double minSize) const;
+    void generate(const double minSize);
+    double getRadius() const;
+    const std::vector<HyperbolicTile>& getTiles() const;
+    const std::vector<int>& getNeighbors() const;
+    std::complex<double> getVertex(const HyperbolicTile& tile,
+                                   const int vertex) const;
+};
+
+#endif /* HYPERBOLIC_TILING_H */
@@ -0,0 +1,104 @@
+#include "imageExport.h"
+#include "framebuffer.h"
+#include "pngWriter.h"
+#include "utils.h"
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <vector>
+
+using namespace glm;
+
+// pixels drawn at once, which bounds the memory used by large images
+static const int TILE_PIXELS = 1 << 22;
+// widest tile, so that tall strips of narrow images stay drawable
+static const int MAX_TILE_WIDTH = 4096;
+
+/// @brief View drawing the `width` x `height` pixels of `view` whose top
+/// left corner is `left` pixels from its left side and `top` pixels from
+/// its top.
+///
+/// Normalized device coordinates of the tile are those of `view` scaled
+/// around the center of the tile, so the scale of both views is the same in
+/// pixels, and the visible bounds of the tile cull the chunks outside it.
+static View getTileView(const View& view, const int left, const int top,
+                        const int width, const int height) {
+    View tile = view;
+    tile.resize(width, height);
+    const vec2 center(-1.0f + (2.0f * left + width) / view.width,
+                      1.0f - (2.0f * top + height) / view.height);
+    const vec2 scale(static_cast<float>(view.width) / width,
+                     static_cast<float>(view.height) / height);
+    for (int column = 0; column < 2; column++) {
+        tile.viewMatrix[column] = scale * view.windowSize *
+                                  view.viewMatrix[column] / tile.windowSize;
+    }
+    tile.viewMatrix[2] =
+        scale * (view.windowSize * view.viewMatrix[2] - center) /
+        tile.windowSize;
+    return tile;
+}
+
+/// @brief Draw `scene` as seen from `view` and write it to the PNG file
+/// `filename`, in `view.width` x `view.height` pixels. Needs a current
+/// OpenGL context, with or without a window.
+///
+/// Images of any size, such as posters of 40000 x 40000 pixels, are drawn
+/// in a framebuffer of at most `TILE_PIXELS` pixels: each strip of rows is
+/// drawn tile by tile through sub-views of `view`, then streamed to the
+/// file, so only one strip is ever in memory.
+/// @return whether the file was written
+bool renderToPng(Renderer& renderer, const Scene& scene, const View& view,
+                 const std::string& filename) {
+    int maxViewport[2] = {};
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    int maxRenderbuffer = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    const int tileWidth = std::min(
+        {view.width, MAX_TILE_WIDTH, maxViewport[0], maxRenderbuffer});
+    const int tileHeight =
+        std::min({view.height, std::max(1, TILE_PIXELS / tileWidth),
+                  maxViewport[1], maxRenderbuffer});
+    Framebuffer framebuffer(tileWidth, tileHeight);
+    if (!framebuffer.isComplete()) {
+        logError("Failed to create a framebuffer for the image.");
+        return false;
+    }
+    PngWriter png(filename, view.width, view.height);
+    if (!png.isValid()) {
+        return false;
+    }
+
+    std::vector<unsigned char> strip{};
+    std::vector<unsigned char> rgb{};
+    framebuffer.bind();
+    for (int top = 0; top < view.height; top += tileHeight) {
+        const int height = std::min(tileHeight, view.height - top);
+        strip.resize(3 * static_cast<std::size_t>(view.width) * height);
+        for (int left = 0; left < view.width; left += tileWidth) {
+            const int width = std::min(tileWidth, view.width - left);
+            renderer.render(scene,
+                            getTileView(view, left, top, width, height));
+            framebuffer.readPixels(width, height, rgb);
+            for (int y = 0; y < height; y++) {
+                std::copy(rgb.begin() + 3 * width * y,
+                          rgb.begin() + 3 * width * (y + 1),
+                          strip.begin() + 3 * (view.width * y + left));
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            png.writeRow(&strip[3 * static_cast<std::size_t>(view.width) * y]);
+        }
+    }
+    framebuffer.unbind();
+
+    if (!png.close()) {
+        logError("Failed to write the image.");
+        return false;
+    }
+    std::clog << "Rendered " << scene.getNbPolygons() << " polygons to "
+              << filename << " (" << view.width << "x" << view.height << ")."
+              << std::endl;
+    return true;
+}
@@ -0,0 +1,11 @@
+#ifndef IMAGE_EXPORT_H
+#define IMAGE_EXPORT_H
+
+#include "renderer.h"
+#include "scene.h"
+#include <string>
+
+bool renderToPng(Renderer& renderer, const Scene& scene, const View& view,
+                 const std::string& filename);
+
+#endif /* IMAGE_EXPORT_H */
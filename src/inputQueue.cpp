@@ -0,0 +1,62 @@
+#include "inputQueue.h"
+
+/// @brief Queue a function modifying the tiling.
+void InputQueue::edit(const std::function<void()>& function) {
+    edits.push_back(function);
+    modified = true;
+}
+
+/// @brief Queue a function only reading the tiling, ordered with the edits.
+void InputQueue::query(const std::function<void()>& function) {
+    edits.push_back(function);
+}
+
+/// @brief Record a cursor position, the first one only sets the origin of
+/// the deltas.
+void InputQueue::moveCursor(const double xpos, const double ypos) {
+    glm::dvec2 position(xpos, ypos);
+    if (hasCursor) {
+        cursorDelta += position - cursor;
+    }
+    cursor = position;
+    hasCursor = true;
+}
+
+/// @brief Record zoom steps, positive to zoom in.
+void InputQueue::zoom(const int steps) { zoomSteps += steps; }
+
+/// @brief Cursor movement since the last call.
+glm::dvec2 InputQueue::takeCursorDelta() {
+    glm::dvec2 delta = cursorDelta;
+    cursorDelta = glm::dvec2(0.0);
+    return delta;
+}
+
+/// @brief Zoom steps since the last call.
+int InputQueue::takeZoomSteps() {
+    int steps = zoomSteps;
+    zoomSteps = 0;
+    return steps;
+}
+
+/// @brief Combine the queued functions into one and empty the queue.
+/// @param publish called last if any edit modified the tiling
+/// @return the combined functions, empty if none were queued
+std::function<void()>
+InputQueue::takeEdits(const std::function<void()>& publish) {
+    if (edits.empty()) {
+        return nullptr;
+    }
+    std::vector<std::function<void()>> batch{};
+    batch.swap(edits);
+    bool publishBatch = modified;
+    modified = false;
+    return [batch, publishBatch, publish]() {
+        for (auto& function : batch) {
+            function();
+        }
+        if (publishBatch) {
+            publish();
+        }
+    };
+}
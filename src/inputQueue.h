@@ -0,0 +1,35 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <functional>
+#include <glm/vec2.hpp>
+#include <vector>
+
+/// @brief Input collected by GLFW callbacks between two frames, applied in
+/// one batch. Non-copyable.
+///
+/// Cursor moves add up to a single delta and zoom presses to a single number
+/// of steps. Edits keep their order and run as one task on the edit thread,
+/// publishing a single scene.
+class InputQueue {
+    std::vector<std::function<void()>> edits{};
+    bool modified = false;
+    glm::dvec2 cursor{};
+    bool hasCursor = false;
+    glm::dvec2 cursorDelta{};
+    int zoomSteps{};
+
+  public:
+    InputQueue() {}
+    InputQueue(const InputQueue&) = delete;
+    InputQueue& operator=(const InputQueue&) = delete;
+    void edit(const std::function<void()>& function);
+    void query(const std::function<void()>& function);
+    void moveCursor(const double xpos, const double ypos);
+    void zoom(const int steps);
+    glm::dvec2 takeCursorDelta();
+    int takeZoomSteps();
+    std::function<void()> takeEdits(const std::function<void()>& publish);
+};
+
+#endif /* INPUT_QUEUE_H */
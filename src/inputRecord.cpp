@@ -0,0 +1,157 @@
+#include "inputRecord.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+static const char* HEADER = "input 1";
+
+InputRecorder::InputRecorder(const std::string& filename)
+    : file(filename, std::ios::binary) {
+    if (!file) {
+        logError("Failed to create the input file.");
+        return;
+    }
+    valid = true;
+    file << HEADER << "\n";
+}
+
+bool InputRecorder::isValid() const { return valid; }
+
+/// @brief Write an event line, with enough digits to replay the same cursor
+/// positions.
+void InputRecorder::record(const InputEvent& event) {
+    if (!valid) {
+        return;
+    }
+    char line[128] = {};
+    switch (event.type) {
+        case InputEventType::key:
+            std::snprintf(line, sizeof(line), "%.6f key %d %d %d\n",
+                          event.time, event.code, event.action, event.mods);
+            break;
+        case InputEventType::cursor:
+            std::snprintf(line, sizeof(line), "%.6f cursor %.17g %.17g\n",
+                          event.time, event.position.x, event.position.y);
+            break;
+        case InputEventType::button:
+            std::snprintf(line, sizeof(line), "%.6f button %d %d %d\n",
+                          event.time, event.code, event.action, event.mods);
+            break;
+        case InputEventType::resize:
+            std::snprintf(line, sizeof(line), "%.6f resize %d %d\n",
+                          event.time, event.code, event.action);
+            break;
+        case InputEventType::frame:
+            std::snprintf(line, sizeof(line), "%.6f frame\n", event.time);
+            break;
+    }
+    file << line;
+}
+
+/// @brief Write the remaining lines.
+/// @return whether the whole file was written successfully
+bool InputRecorder::close() {
+    if (!valid) {
+        return false;
+    }
+    valid = false;
+    file.close();
+    return static_cast<bool>(file);
+}
+
+/// @brief Parse an event line of an input file.
+/// @return whether the line is a valid event
+static bool parseEvent(const std::string& line, InputEvent& event) {
+    char keyword[16] = {};
+    int offset = 0;
+    if (std::sscanf(line.c_str(), "%lf %15s %n", &event.time, keyword,
+                    &offset) != 2) {
+        return false;
+    }
+    const char* numbers = line.c_str() + offset;
+    if (std::strcmp(keyword, "key") == 0) {
+        event.type = InputEventType::key;
+        return std::sscanf(numbers, "%d %d %d", &event.code, &event.action,
+                           &event.mods) == 3;
+    }
+    if (std::strcmp(keyword, "cursor") == 0) {
+        event.type = InputEventType::cursor;
+        return std::sscanf(numbers, "%lf %lf", &event.position.x,
+                           &event.position.y) == 2;
+    }
+    if (std::strcmp(keyword, "button") == 0) {
+        event.type = InputEventType::button;
+        return std::sscanf(numbers, "%d %d %d", &event.code, &event.action,
+                           &event.mods) == 3;
+    }
+    if (std::strcmp(keyword, "resize") == 0) {
+        event.type = InputEventType::resize;
+        return std::sscanf(numbers, "%d %d", &event.code, &event.action) == 2;
+    }
+    if (std::strcmp(keyword, "frame") == 0) {
+        event.type = InputEventType::frame;
+        return true;
+    }
+    return false;
+}
+
+/// @brief Read the events of an input file written by `InputRecorder`.
+/// @param filename
+/// @param events replaced by the events of the file, in order
+/// @return whether the whole file was read, errors are logged
+bool readInputEvents(const std::string& filename,
+                     std::vector<InputEvent>& events) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        logError("Failed to open the input file.");
+        return false;
+    }
+    events.clear();
+    std::string line{};
+    if (!std::getline(file, line) || line != HEADER) {
+        logError("Not an input file.");
+        return false;
+    }
+    int lineNumber = 1;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        InputEvent event{};
+        if (!parseEvent(line, event)) {
+            logError(("Invalid input event on line " +
+                      std::to_string(lineNumber) + ".")
+                         .c_str());
+            return false;
+        }
+        events.push_back(event);
+    }
+    return true;
+}
+
+void LatencyStats::add(const double seconds) { samples.push_back(seconds); }
+
+/// @brief Print the number of samples, then their mean, median, 95th and 99th
+/// percentiles and maximum in milliseconds.
+void LatencyStats::report(std::ostream& stream, const char* name) const {
+    stream << name << ": " << samples.size();
+    if (samples.empty()) {
+        stream << std::endl;
+        return;
+    }
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](const double fraction) {
+        return 1e3 * sorted[static_cast<std::size_t>(fraction *
+                                                     (sorted.size() - 1))];
+    };
+    const double mean =
+        std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    stream << ", mean " << 1e3 * mean << " ms, median " << percentile(0.5)
+           << " ms, 95% " << percentile(0.95) << " ms, 99% "
+           << percentile(0.99) << " ms, max " << 1e3 * sorted.back() << " ms"
+           << std::endl;
+}
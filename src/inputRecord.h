@@ -0,0 +1,67 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <fstream>
+#include <glm/vec2.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief Kind of line of an input file.
+enum class InputEventType { key, cursor, button, resize, frame };
+
+/// @brief GLFW input event handled by the window, or the end of the input
+/// of a frame, applied in one batch by `TilingApp::processInput`.
+struct InputEvent {
+    InputEventType type = InputEventType::frame;
+    // seconds since the start of the recording
+    double time{};
+    // key: GLFW key, action and modifiers; button: GLFW mouse button,
+    // action and modifiers; resize: width and height in `code` and `action`
+    int code{};
+    int action{};
+    int mods{};
+    // cursor: position in screen coordinates
+    glm::dvec2 position{};
+};
+
+/// @brief Writes input events to a text file one line per event.
+/// Non-copyable.
+///
+/// The file starts with the line `input 1` (the version of the format),
+/// followed by lines made of a time in seconds, a keyword and numbers
+/// separated by spaces:
+/// - `TIME key KEY ACTION MODS`
+/// - `TIME cursor X Y`
+/// - `TIME button BUTTON ACTION MODS`
+/// - `TIME resize WIDTH HEIGHT`
+/// - `TIME frame` after the events of each frame
+///
+/// Empty lines and lines starting with `#` are ignored.
+class InputRecorder {
+    std::ofstream file{};
+    bool valid = false;
+
+  public:
+    InputRecorder(const std::string& filename);
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+    bool isValid() const;
+    void record(const InputEvent& event);
+    bool close();
+};
+
+bool readInputEvents(const std::string& filename,
+                     std::vector<InputEvent>& events);
+
+/// @brief Durations of repeated operations, summarized by their mean,
+/// percentiles and maximum.
+class LatencyStats {
+    std::vector<double> samples{};
+
+  public:
+    void add(const double seconds);
+    void report(std::ostream& stream, const char* name) const;
+};
+
+#endif /* INPUT_RECORD_H */
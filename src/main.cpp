@@ -1,4 +1,6 @@
+#include "benchmark.h"
 #include "config.h"
+#include "headless.h"
 #include "tilingApp.h"
 #include "utils.h"
 #define GLFW_INCLUDE_NONE
@@ -7,11 +9,23 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 std::string getWindowTitle();
 void framebufferSizeCallback(GLFWwindow* window, int height, int width);
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        runBenchmarks(std::cout);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--stress") {
+        return runStressTest(std::cout,
+                             std::vector<std::string>(argv + 2, argv + argc));
+    }
+    if (argc > 1 && std::string(argv[1]) == "--render") {
+        return runHeadless(std::vector<std::string>(argv + 2, argv + argc));
+    }
     // Initialize GLFW, create a window, load GLAD...
     if (!glfwInit()) {
         logError("Failed to initialize GLFW");
@@ -48,12 +62,21 @@ int main() {
 
     {
         std::unique_ptr<TilingApp> app(new TilingApp(window));
-        app->debug();
-
-        while (!glfwWindowShouldClose(window)) {
-            app->render();
+        // record or replay the input of the session
+        bool inputReady = true;
+        for (int arg = 1; arg + 1 < argc; arg++) {
+            const std::string option(argv[arg]);
+            const bool fast =
+                arg + 2 < argc && std::string(argv[arg + 2]) == "--fast";
+            if ((option == "--record" && !app->record(argv[arg + 1])) ||
+                (option == "--replay" && !app->replay(argv[arg + 1], fast))) {
+                inputReady = false;
+            }
+        }
+        if (inputReady) {
+            app->debug();
+            app->run();
         }
-        // delete GL objects before GLFW is terminated
     }
 
     glfwDestroyWindow(window);
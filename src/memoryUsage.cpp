@@ -0,0 +1,24 @@
+#include "memoryUsage.h"
+
+std::size_t MemoryUsage::getTotal() const {
+    return polygons + boundary + links + geometry + graph + vertices +
+           gpuBuffers;
+}
+
+/// @brief Print the bytes of each subsystem, in total and per polygon.
+void MemoryUsage::report(std::ostream& stream, const int nbPolygons) const {
+    const std::pair<const char*, std::size_t> subsystems[] = {
+        {"polygons", polygons}, {"boundary", boundary},
+        {"links", links},       {"geometry", geometry},
+        {"graph", graph},       {"vertices", vertices},
+        {"GPU buffers", gpuBuffers}};
+    const double divisor = nbPolygons > 0 ? nbPolygons : 1;
+    stream << "Memory: " << getTotal() << " bytes for " << nbPolygons
+           << " polygons (" << getTotal() / divisor << " per polygon)"
+           << std::endl;
+    for (auto& subsystem : subsystems) {
+        stream << "  " << subsystem.first << ": " << subsystem.second
+               << " bytes (" << subsystem.second / divisor << " per polygon)"
+               << std::endl;
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// bytes of the control block of a shared_ptr created from a raw pointer
+// (virtual table, use and weak counts, pointer)
+const std::size_t SHARED_PTR_CONTROL_BYTES =
+    sizeof(void*) + 2 * sizeof(int) + sizeof(void*);
+
+/// @brief Bytes allocated by `vector` for its elements.
+template <typename T>
+std::size_t vectorBytes(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+/// @brief Bytes of the nodes of `list`: each holds its element and two
+/// links.
+template <typename T> std::size_t listBytes(const std::list<T>& list) {
+    return list.size() * (sizeof(T) + 2 * sizeof(void*));
+}
+
+/// @brief Bytes of the nodes and buckets of `map`: each node holds its pair,
+/// a link and the cached hash of its key, each bucket a pointer.
+template <typename K, typename V, typename H>
+std::size_t unorderedMapBytes(const std::unordered_map<K, V, H>& map) {
+    return map.size() * (sizeof(std::pair<const K, V>) + sizeof(void*) +
+                         sizeof(std::size_t)) +
+           map.bucket_count() * sizeof(void*);
+}
+
+/// @brief Bytes of the nodes of `map`: each holds its pair, three links and
+/// a color.
+template <typename K, typename V>
+std::size_t mapBytes(const std::map<K, V>& map) {
+    return map.size() * (sizeof(std::pair<const K, V>) + 4 * sizeof(void*));
+}
+
+/// @brief Bytes used by each subsystem of a tiling, computed from the sizes
+/// and capacities of their containers rather than measured, so they don't
+/// include the headers of the allocator (often 8 to 16 bytes per
+/// allocation).
+struct MemoryUsage {
+    // Polygon objects, their points, their shared_ptr and its control block
+    std::size_t polygons{};
+    // list nodes of the edges accessible to the cursor, and their index
+    std::size_t boundary{};
+    // two hash map nodes per pair of linked sides
+    std::size_t links{};
+    std::size_t geometry{};
+    std::size_t graph{};
+    std::size_t vertices{};
+    // instance and segment buffers of the renderer
+    std::size_t gpuBuffers{};
+
+    std::size_t getTotal() const;
+    void report(std::ostream& stream, const int nbPolygons) const;
+};
+
+#endif /* MEMORY_USAGE_H */
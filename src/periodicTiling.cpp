@@ -0,0 +1,295 @@
+#include "periodicTiling.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+// translations of the motif per chunk side
+static const int CHUNK_CELLS = 16;
+// chunks kept in memory, visible or not
+static const std::size_t MAX_CHUNKS = 64;
+// length of the sides of the polygons, as in Polygon
+static const double EDGE = 0.2;
+
+/// @brief Regular polygon with its first vertex at (x, y) and its first
+/// side starting in direction `angle` (in degrees), for sides of length 1.
+struct MotifPolygon {
+    int nbSides{};
+    double x{};
+    double y{};
+    double angle{};
+    MotifPolygon(const int nbSides, const double x, const double y,
+                 const double angle)
+        : nbSides(nbSides), x(x), y(y), angle(angle) {};
+};
+
+struct Preset {
+    std::string name{};
+    dvec2 periods[2]{};
+    std::vector<MotifPolygon> polygons{};
+    Preset(const std::string& name, const dvec2& period0, const dvec2& period1,
+           const std::vector<MotifPolygon>& polygons)
+        : name(name), periods{period0, period1}, polygons(polygons) {};
+};
+
+static dvec2 direction(const double degrees) {
+    double radians = degrees * pi<double>() / 180.0;
+    return dvec2(std::cos(radians), std::sin(radians));
+}
+
+/// @brief Dodecagon surrounded by polygons with `nbSides0` sides on its even
+/// sides and `nbSides1` on its odd sides, repeated across its even sides.
+static Preset dodecagonPreset(const std::string& name, const int nbSides0,
+                              const int nbSides1) {
+    // distance between the centers of dodecagons on both sides of a polygon
+    const double distance =
+        2.0 + std::sqrt(3.0) + (nbSides0 == 4 ? 1.0 : 0.0);
+    std::vector<MotifPolygon> polygons{{12, 0.0, 0.0, 0.0}};
+    dvec2 vertex(0.0);
+    // the other sides belong to the neighbors
+    for (int side = 0; side < 5; side++) {
+        vertex += direction(30.0 * side);
+        int nbSides = side % 2 ? nbSides1 : nbSides0;
+        if (nbSides != 12) {
+            polygons.emplace_back(nbSides, vertex.x, vertex.y,
+                                  30.0 * side + 180.0);
+        }
+    }
+    return Preset(name, distance * direction(-90.0),
+                  distance * direction(-30.0), polygons);
+}
+
+/// @brief The Archimedean tilings made of triangles, squares, hexagons,
+/// octagons and dodecagons, except the chiral ones.
+static const std::vector<Preset>& getPresets() {
+    static const double h = std::sqrt(3.0) / 2.0;
+    static const double c = std::sqrt(2.0) / 2.0;
+    static const std::vector<Preset> presets = {
+        Preset("4.4.4.4", dvec2(1.0, 0.0), dvec2(0.0, 1.0),
+               {{4, 0.0, 0.0, 0.0}}),
+        Preset("3.3.3.3.3.3", dvec2(1.0, 0.0), dvec2(0.5, h),
+               {{3, 0.0, 0.0, 0.0}, {3, 1.5, h, 180.0}}),
+        Preset("6.6.6", dvec2(1.5, h), dvec2(0.0, 2.0 * h),
+               {{6, 0.0, 0.0, 0.0}}),
+        Preset("3.6.3.6", dvec2(2.0, 0.0), dvec2(1.0, 2.0 * h),
+               {{6, 0.0, 0.0, 0.0},
+                {3, 2.0, 2.0 * h, 180.0},
+                {3, 1.5, h, 240.0}}),
+        Preset("3.4.6.4", (1.0 + 2.0 * h) * direction(-90.0),
+               (1.0 + 2.0 * h) * direction(-30.0),
+               {{6, 0.0, 0.0, 0.0},
+                {4, 1.0, 0.0, 180.0},
+                {4, 1.5, h, 240.0},
+                {4, 0.0, 0.0, 120.0},
+                {3, 1.0, 0.0, 270.0},
+                {3, 0.0, 0.0, 210.0}}),
+        Preset("4.8.8", dvec2(1.0 + 2.0 * c, 0.0), dvec2(0.0, 1.0 + 2.0 * c),
+               {{8, 0.0, 0.0, 0.0}, {4, 1.0 + c, c, 225.0}}),
+        dodecagonPreset("4.6.12", 4, 6),
+        dodecagonPreset("3.12.12", 12, 3),
+        Preset("3.3.3.4.4", dvec2(1.0, 0.0), dvec2(0.5, 1.0 + h),
+               {{4, 0.0, 0.0, 0.0},
+                {3, 0.0, 1.0, 0.0},
+                {3, 1.5, 1.0 + h, 180.0}})};
+    return presets;
+}
+
+/// @brief Fill `chunk` with the translations of `motif` by (i, j) in the
+/// basis `periods`, for i and j in the range of chunk `key`, relative to the
+/// first one.
+static void generateChunk(const std::vector<PeriodicTile>& motif,
+                          const dvec2 periods[2],
+                          const std::pair<int, int>& key,
+                          PeriodicChunk& chunk) {
+    vec2 motifMin(INFINITY), motifMax(-INFINITY);
+    for (auto& tile : motif) {
+        for (auto& point : regularPolygon(tile.nbSides)) {
+            vec2 vertex = tile.modelMatrix * vec3(vec2(point), 1.0);
+            motifMin = glm::min(motifMin, vertex);
+            motifMax = glm::max(motifMax, vertex);
+        }
+    }
+    chunk.origin =
+        static_cast<double>(key.first) * CHUNK_CELLS * periods[0] +
+        static_cast<double>(key.second) * CHUNK_CELLS * periods[1];
+    chunk.tiles.clear();
+    chunk.min = vec2(INFINITY);
+    chunk.max = vec2(-INFINITY);
+    for (int i = 0; i < CHUNK_CELLS; i++) {
+        for (int j = 0; j < CHUNK_CELLS; j++) {
+            vec2 offset = vec2(static_cast<double>(i) * periods[0] +
+                               static_cast<double>(j) * periods[1]);
+            for (auto& tile : motif) {
+                chunk.tiles.push_back(tile);
+                chunk.tiles.back().modelMatrix[2] += offset;
+            }
+            chunk.min = glm::min(chunk.min, motifMin + offset);
+            chunk.max = glm::max(chunk.max, motifMax + offset);
+        }
+    }
+}
+
+PeriodicTiling::PeriodicTiling(const std::function<void()>& onReady)
+    : onReady(onReady) {
+    setPreset(0);
+}
+
+/// @brief Wait for the chunks being generated.
+PeriodicTiling::~PeriodicTiling() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return running == 0; });
+}
+
+int PeriodicTiling::getNbPresets() { return getPresets().size(); }
+
+/// @brief Replace the tiling by preset `preset`, forgetting all chunks.
+void PeriodicTiling::setPreset(const int preset) {
+    const Preset& current = getPresets()[preset];
+    this->preset = preset;
+    motif.clear();
+    for (auto& polygon : current.polygons) {
+        vec2 a = vec2(EDGE * dvec2(polygon.x, polygon.y));
+        vec2 diff = vec2(EDGE * direction(polygon.angle));
+        motif.emplace_back(mat3x2(diff.x, diff.y, -diff.y, diff.x, a.x, a.y),
+                           polygon.nbSides);
+    }
+    periods[0] = EDGE * current.periods[0];
+    periods[1] = EDGE * current.periods[1];
+    chunks.clear();
+    recent.clear();
+    pending.clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.clear();
+    generation++;
+}
+
+int PeriodicTiling::getPreset() const { return preset; }
+
+/// @brief Vertex configuration of the tiling, e.g. "4.8.8".
+std::string PeriodicTiling::getName() const {
+    return getPresets()[preset].name;
+}
+
+/// @brief Whether chunks finished since the last `update`. Thread-safe.
+bool PeriodicTiling::hasReadyChunks() const { return hasReady; }
+
+/// @brief Whether requested chunks weren't kept by `update` yet.
+bool PeriodicTiling::hasPendingChunks() const { return !pending.empty(); }
+
+/// @brief Keep the finished chunks, then request the chunks intersecting
+/// the box which are neither kept nor being generated, and forget the
+/// chunks seen least recently beyond `MAX_CHUNKS`.
+/// @param min
+/// @param max
+/// @param pool generates the requested chunks
+/// @return whether the kept chunks changed
+bool PeriodicTiling::update(const dvec2& min, const dvec2& max,
+                            ThreadPool& pool) {
+    const std::size_t nbChunks = chunks.size();
+    collectReady();
+    bool changed = chunks.size() != nbChunks;
+
+    // range of chunks around the box, in the basis of the periods
+    const dmat2 basis(periods[0], periods[1]);
+    const dmat2 toLattice = inverse(basis);
+    dvec2 low(INFINITY), high(-INFINITY);
+    for (double x : {min.x, max.x}) {
+        for (double y : {min.y, max.y}) {
+            dvec2 cell =
+                toLattice * dvec2(x, y) / static_cast<double>(CHUNK_CELLS);
+            low = glm::min(low, cell);
+            high = glm::max(high, cell);
+        }
+    }
+    // when zoomed out, the chunks nearest to the center of the box, among
+    // a window of a few more than can be kept
+    const dvec2 center = toLattice * ((min + max) / 2.0) /
+                         static_cast<double>(CHUNK_CELLS);
+    const dvec2 radius(std::sqrt(static_cast<double>(MAX_CHUNKS)) / 2.0 + 1.0);
+    low = glm::max(low, center - radius);
+    high = glm::min(high, center + radius);
+    // chunks overlap their neighbors
+    std::vector<std::pair<int, int>> visible{};
+    for (int i = std::floor(low.x) - 1; i <= std::floor(high.x) + 1; i++) {
+        for (int j = std::floor(low.y) - 1; j <= std::floor(high.y) + 1; j++) {
+            visible.emplace_back(i, j);
+        }
+    }
+    auto distance = [&center](const std::pair<int, int>& key) {
+        dvec2 chunkCenter = dvec2(key.first + 0.5, key.second + 0.5);
+        return dot(chunkCenter - center, chunkCenter - center);
+    };
+    std::sort(visible.begin(), visible.end(),
+              [&distance](const std::pair<int, int>& a,
+                          const std::pair<int, int>& b) {
+                  return distance(a) < distance(b);
+              });
+    visible.resize(std::min(visible.size(), MAX_CHUNKS));
+
+    for (auto it = visible.rbegin(); it != visible.rend(); it++) {
+        auto chunk = chunks.find(*it);
+        if (chunk != chunks.end()) {
+            recent.splice(recent.begin(), recent, chunk->second.recent);
+        } else if (!pending.count(*it)) {
+            request(*it, pool);
+        }
+    }
+    while (chunks.size() > MAX_CHUNKS) {
+        chunks.erase(recent.back());
+        recent.pop_back();
+        changed = true;
+    }
+    return changed;
+}
+
+/// @brief Move the chunks finished for the current preset to `chunks`.
+void PeriodicTiling::collectReady() {
+    std::vector<std::pair<std::pair<int, int>, PeriodicChunk>> done{};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(ready);
+        hasReady = false;
+    }
+    for (auto& chunk : done) {
+        pending.erase(chunk.first);
+        recent.push_front(chunk.first);
+        chunk.second.recent = recent.begin();
+        chunks[chunk.first] = std::move(chunk.second);
+    }
+}
+
+/// @brief Generate chunk `key` on `pool`.
+void PeriodicTiling::request(const std::pair<int, int>& key,
+                             ThreadPool& pool) {
+    pending.insert(key);
+    int current{};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running++;
+        current = generation;
+    }
+    const std::vector<PeriodicTile> motif = this->motif;
+    const dvec2 periods[2] = {this->periods[0], this->periods[1]};
+    pool.submit([this, key, current, motif, periods]() {
+        PeriodicChunk chunk{};
+        generateChunk(motif, periods, key, chunk);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (current == generation) {
+                ready.emplace_back(key, std::move(chunk));
+                hasReady = true;
+            }
+        }
+        onReady();
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        finished.notify_all();
+    });
+}
+
+const std::map<std::pair<int, int>, PeriodicChunk>&
+PeriodicTiling::getChunks() const {
+    return chunks;
+}
@@ -0,0 +1,92 @@
+#ifndef PERIODIC_TILING_H
+#define PERIODIC_TILING_H
+
+#include "threadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <glm/mat3x2.hpp>
+#include <glm/vec2.hpp>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief Regular polygon of a periodic tiling, positioned like a Polygon.
+struct PeriodicTile {
+    glm::mat3x2 modelMatrix{};
+    int nbSides{};
+    PeriodicTile(const glm::mat3x2& modelMatrix, const int nbSides)
+        : modelMatrix(modelMatrix), nbSides(nbSides) {};
+};
+
+/// @brief Tiles of `CHUNK_CELLS` x `CHUNK_CELLS` translations of the motif.
+/// The tiles and bounds are relative to `origin`, so that they stay precise
+/// in float far from (0, 0).
+struct PeriodicChunk {
+    glm::dvec2 origin{};
+    std::vector<PeriodicTile> tiles{};
+    glm::vec2 min{};
+    glm::vec2 max{};
+    // position in `PeriodicTiling::recent`
+    std::list<std::pair<int, int>>::iterator recent{};
+};
+
+/// @brief Archimedean tiling covering the whole plane, streamed in chunks.
+/// Non-copyable.
+///
+/// The plane is divided into chunks of the lattice of the tiling, generated
+/// on worker threads when they become visible. Finished chunks wait in
+/// `ready` until the next `update` on the owning thread, which keeps the
+/// `MAX_CHUNKS` chunks used most recently and forgets the others.
+/// `onReady` is called from the workers when a chunk is finished.
+class PeriodicTiling {
+    int preset{};
+    std::vector<PeriodicTile> motif{};
+    glm::dvec2 periods[2]{};
+    std::map<std::pair<int, int>, PeriodicChunk> chunks{};
+    // most recently visible first
+    std::list<std::pair<int, int>> recent{};
+    std::set<std::pair<int, int>> pending{};
+    std::function<void()> onReady{};
+    // shared with the workers
+    std::mutex mutex{};
+    std::condition_variable finished{};
+    std::vector<std::pair<std::pair<int, int>, PeriodicChunk>> ready{};
+    std::atomic<bool> hasReady{false};
+    int running{};
+    // ready chunks of older presets are dropped
+    int generation{};
+
+    void collectReady();
+    void request(const std::pair<int, int>& key, ThreadPool& pool);
+
+  public:
+    PeriodicTiling(const std::function<void()>& onReady);
+    ~PeriodicTiling();
+    PeriodicTiling(const PeriodicTiling&) = delete;
+    PeriodicTiling& operator=(const PeriodicTiling&) = delete;
+    static int getNbPresets();
+    void setPreset(const int preset);
+    int getPreset() const;
+    std::string getName() const;
+    bool hasReadyChunks() const;
+    bool hasPendingChunks() const;
+    bool update(const glm::dvec2& min, const glm::dvec2& max,
+                ThreadPool& pool);
+    const std::map<std::pair<int, int>, PeriodicChunk>& getChunks() const;
+};
+
+static_assert(!std::is_copy_constructible<PeriodicTiling>::value,
+              "PeriodicTiling shouldn't be copy constructible.");
+static_assert(!std::is_copy_assignable<PeriodicTiling>::value,
+              "PeriodicTiling shouldn't be copy assignable.");
+static_assert(!std::is_move_constructible<PeriodicTiling>::value,
+              "PeriodicTiling shouldn't be move constructible.");
+static_assert(!std::is_move_assignable<PeriodicTiling>::value,
+              "PeriodicTiling shouldn't be move assignable.");
+
+#endif /* PERIODIC_TILING_H */
@@ -0,0 +1,129 @@
+#include "pngWriter.h"
+#include "utils.h"
+#include <cstring>
+
+// compressed bytes gathered before writing an IDAT chunk
+static const std::size_t CHUNK_CAPACITY = 1 << 16;
+
+static void putUint32(unsigned char* bytes, const unsigned long value) {
+    bytes[0] = (value >> 24) & 0xff;
+    bytes[1] = (value >> 16) & 0xff;
+    bytes[2] = (value >> 8) & 0xff;
+    bytes[3] = value & 0xff;
+}
+
+/// @brief Create `filename` and write the signature and header of a
+/// `width` x `height` image.
+PngWriter::PngWriter(const std::string& filename, const int width,
+                     const int height)
+    : file(filename, std::ios::binary), filtered(3 * width + 1),
+      width(width), height(height) {
+    if (!file || width <= 0 || height <= 0) {
+        logError("Failed to create the PNG file.");
+        return;
+    }
+    // flat colors compress well even at the fastest level
+    if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+        logError("Failed to initialize zlib.");
+        return;
+    }
+    valid = true;
+    const unsigned char signature[] = {0x89, 'P', 'N', 'G',
+                                       '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+    unsigned char header[13] = {};
+    putUint32(header, width);
+    putUint32(header + 4, height);
+    // 8 bits per channel, RGB, no interlacing
+    header[8] = 8;
+    header[9] = 2;
+    writeChunk("IHDR", header, sizeof(header));
+}
+
+PngWriter::~PngWriter() {
+    if (valid) {
+        logError("PNG file left incomplete.");
+        deflateEnd(&stream);
+    }
+}
+
+bool PngWriter::isValid() const { return valid; }
+
+/// @brief Append the next row of the image.
+/// @param rgb `3 * width` bytes
+void PngWriter::writeRow(const unsigned char* rgb) {
+    if (!valid || rows == height) {
+        return;
+    }
+    // "Sub" filter: runs of the same color become runs of zeros
+    filtered[0] = 1;
+    for (int n = 0; n < 3 * width; n++) {
+        filtered[n + 1] = rgb[n] - (n >= 3 ? rgb[n - 3] : 0);
+    }
+    valid = compress(filtered.data(), filtered.size(), Z_NO_FLUSH);
+    rows++;
+}
+
+/// @brief Write the remaining data and the end of the file.
+/// @return whether the whole image was written successfully
+bool PngWriter::close() {
+    if (!valid) {
+        return false;
+    }
+    if (rows != height) {
+        logError("PNG file closed before its last row.");
+    }
+    bool success = compress(nullptr, 0, Z_FINISH) && rows == height;
+    deflateEnd(&stream);
+    valid = false;
+    if (!compressed.empty()) {
+        writeChunk("IDAT", compressed.data(), compressed.size());
+    }
+    writeChunk("IEND", nullptr, 0);
+    file.close();
+    return success && file;
+}
+
+/// @brief Deflate `data` into `compressed`, writing IDAT chunks whenever it
+/// is full.
+/// @return whether zlib succeeded
+bool PngWriter::compress(const unsigned char* data, const std::size_t size,
+                         const int flush) {
+    stream.next_in = const_cast<unsigned char*>(data);
+    stream.avail_in = size;
+    while (true) {
+        const std::size_t used = compressed.size();
+        compressed.resize(CHUNK_CAPACITY);
+        stream.next_out = compressed.data() + used;
+        stream.avail_out = CHUNK_CAPACITY - used;
+        int result = deflate(&stream, flush);
+        compressed.resize(CHUNK_CAPACITY - stream.avail_out);
+        if (result == Z_STREAM_ERROR) {
+            logError("Failed to compress the PNG data.");
+            return false;
+        }
+        if (compressed.size() == CHUNK_CAPACITY) {
+            writeChunk("IDAT", compressed.data(), compressed.size());
+            compressed.clear();
+        } else if (stream.avail_in == 0 &&
+                   (flush != Z_FINISH || result == Z_STREAM_END)) {
+            return true;
+        }
+    }
+}
+
+/// @brief Write a chunk with its length and checksum.
+void PngWriter::writeChunk(const char* type, const unsigned char* data,
+                           const std::size_t size) {
+    unsigned char bytes[4] = {};
+    putUint32(bytes, size);
+    file.write(reinterpret_cast<const char*>(bytes), 4);
+    file.write(type, 4);
+    unsigned long crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+    if (size) {
+        file.write(reinterpret_cast<const char*>(data), size);
+        crc = crc32(crc, data, size);
+    }
+    putUint32(bytes, crc);
+    file.write(reinterpret_cast<const char*>(bytes), 4);
+}
@@ -0,0 +1,42 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+/// @brief Writes an 8-bit RGB image to a PNG file one row at a time, from
+/// top to bottom. Non-copyable.
+///
+/// Rows are compressed as they arrive and written out in IDAT chunks of
+/// bounded size, so memory use doesn't depend on the height of the image.
+class PngWriter {
+    std::ofstream file{};
+    z_stream stream{};
+    // compressed data not written yet
+    std::vector<unsigned char> compressed{};
+    // filter type byte followed by the filtered row
+    std::vector<unsigned char> filtered{};
+    int width{};
+    int height{};
+    int rows{};
+    bool valid = false;
+
+    void writeChunk(const char* type, const unsigned char* data,
+                    const std::size_t size);
+    bool compress(const unsigned char* data, const std::size_t size,
+                  const int flush);
+
+  public:
+    PngWriter(const std::string& filename, const int width, const int height);
+    ~PngWriter();
+    PngWriter(const PngWriter&) = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+    bool isValid() const;
+    void writeRow(const unsigned char* rgb);
+    bool close();
+};
+
+#endif /* PNG_WRITER_H */
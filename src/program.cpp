@@ -1,35 +1,184 @@
 #include "program.h"
+#include "programCache.h"
 #include "utils.h"
+#include <chrono>
 #include <glad/glad.h>
+#include <iostream>
+#include <string>
 
-/// @brief Position vec2 `points` on the xy plane using uniform mat3x2
-/// `position`.
+/// @brief Position a vertex on the xy plane using the model matrix of the
+/// polygon instance (attributes 1 to 3), then uniform mat3x2 `view3x2`.
+///
+/// Polygon instances have `nbSides` > 0: their vertices are generated from
+/// `gl_VertexID` on the unit-sided regular polygon starting with (0, 0) and
+/// (1, 0), the same as `regularPolygon`. Vertex 0 is the center of the
+/// polygon, and the vertex ids after the last corner repeat the first one,
+/// so that a triangle fan from 0 fills the polygon, the sides from 1 to the
+/// next vertex outline it, and instances with fewer sides can share a draw
+/// call.
+///
+/// Hyperbolic tiles have `nbSides` < 0 and are numbered the same way, with
+/// `SUBDIVISIONS` points per side (`HYPERBOLIC_SUBDIVISIONS`). The central
+/// {-nbSides, q} tile of the Poincaré disk, whose vertices are at distance
+/// `position2.x` from the center, is moved by the Möbius transformation
+/// with coefficients `position0` and `position1`.
+///
+/// Lines are quads of two triangles, `width` pixels wide whatever the
+/// driver supports for `glLineWidth`. If `outlineWidth` > 0, polygon
+/// instances are outlined rather than filled: vertex `6 * side + corner` is
+/// a corner of the quad along their side `side`, numbered like the sides of
+/// their fan.
+///
+/// Segments have `nbSides` = 0 and draw vertex `corner` of the quad from
+/// `position0` to `position1`, `position2.x` pixels wide, in world
+/// coordinates, or in window coordinates without `view3x2` if
+/// `position2.y` > 0.
 static const char* minimalVertexShader =
     "#version 330 core\n"
-    "layout (location = 0) in vec2 points;\n"
     "// location is the id of the vertex attribute\n"
-    "uniform mat3x2 position3x2;\n"
+    "layout (location = 1) in vec2 position0;\n"
+    "layout (location = 2) in vec2 position1;\n"
+    "layout (location = 3) in vec2 position2;\n"
+    "layout (location = 4) in vec3 instanceColor;\n"
+    "layout (location = 5) in int nbSides;\n"
     "uniform mat3x2 view3x2;\n"
     "uniform vec2 windowSize;\n"
+    "// pixels of the viewport\n"
+    "uniform vec2 viewportSize;\n"
+    "uniform float outlineWidth;\n"
+    "out vec3 vertexColor;\n"
+    "const float PI = 3.14159265358979;\n"
+    "const int SUBDIVISIONS = 8;\n"
+    "// corners of the quad of a line: ends a then b, on the right then left\n"
+    "const int CORNERS[6] = int[6](0, 1, 2, 2, 1, 3);\n"
+    "vec2 polygonVertex(int vertex, int nbSides) {\n"
+    "    // vertices lie on a circle through (0, 0) and (1, 0)\n"
+    "    float angle = 2.0 * PI / float(nbSides);\n"
+    "    vec2 center = vec2(0.5, 0.5 / tan(angle / 2.0));\n"
+    "    if (vertex == 0) {\n"
+    "        return center;\n"
+    "    }\n"
+    "    int corner = vertex > nbSides ? 0 : vertex - 1;\n"
+    "    float radius = 0.5 / sin(angle / 2.0);\n"
+    "    float theta = float(corner) * angle - (PI + angle) / 2.0;\n"
+    "    return center + radius * vec2(cos(theta), sin(theta));\n"
+    "}\n"
+    "// complex numbers\n"
+    "vec2 mul(vec2 a, vec2 b) {\n"
+    "    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);\n"
+    "}\n"
+    "vec2 div(vec2 a, vec2 b) {\n"
+    "    return mul(a, vec2(b.x, -b.y)) / dot(b, b);\n"
+    "}\n"
+    "vec2 conj(vec2 a) {\n"
+    "    return vec2(a.x, -a.y);\n"
+    "}\n"
+    "vec2 mobius(vec2 a, vec2 b, vec2 z) {\n"
+    "    return div(mul(a, z) + b, mul(conj(b), z) + conj(a));\n"
+    "}\n"
+    "// fraction t of the geodesic from a to b, straight once a is moved to 0\n"
+    "vec2 geodesic(vec2 a, vec2 b, float t) {\n"
+    "    vec2 end = mobius(vec2(1.0, 0.0), -a, b);\n"
+    "    float len = length(end);\n"
+    "    vec2 point = end * (tanh(t * atanh(len)) / max(len, 1e-30));\n"
+    "    return mobius(vec2(1.0, 0.0), a, point);\n"
+    "}\n"
+    "vec2 hyperbolicVertex(int vertex, int nbSides, float radius) {\n"
+    "    if (vertex == 0) {\n"
+    "        return vec2(0.0);\n"
+    "    }\n"
+    "    int point = vertex > nbSides * SUBDIVISIONS ? 0 : vertex - 1;\n"
+    "    float side = float(point / SUBDIVISIONS);\n"
+    "    float angle = 2.0 * PI / float(nbSides);\n"
+    "    vec2 a = radius * vec2(cos((side - 0.5) * angle),\n"
+    "                           sin((side - 0.5) * angle));\n"
+    "    vec2 b = radius * vec2(cos((side + 0.5) * angle),\n"
+    "                           sin((side + 0.5) * angle));\n"
+    "    float t = float(point % SUBDIVISIONS) / float(SUBDIVISIONS);\n"
+    "    return geodesic(a, b, t);\n"
+    "}\n"
+    "// normalized device coordinates of vertex `vertex` of the instance\n"
+    "vec2 instanceVertex(int vertex) {\n"
+    "    vec3 world = vec3(0.0);\n"
+    "    if (nbSides < 0) {\n"
+    "        vec2 point = hyperbolicVertex(vertex, -nbSides, position2.x);\n"
+    "        world = vec3(mobius(position0, position1, point), 1.0);\n"
+    "    } else {\n"
+    "        mat3 position = mat3(vec3(position0, 0.0),\n"
+    "                             vec3(position1, 0.0),\n"
+    "                             vec3(position2, 1.0));\n"
+    "        world = position * vec3(polygonVertex(vertex, nbSides), 1.0);\n"
+    "    }\n"
+    "    return (mat3(view3x2) * world).xy * windowSize;\n"
+    "}\n"
+    "// corner of the quad `width` pixels wide around the line from a to b,\n"
+    "// with square caps so that consecutive lines join\n"
+    "vec2 lineCorner(vec2 a, vec2 b, float width, int corner) {\n"
+    "    vec2 direction = (b - a) * viewportSize;\n"
+    "    float len = length(direction);\n"
+    "    direction = len > 0.0 ? direction / len : vec2(0.0);\n"
+    "    vec2 normal = vec2(-direction.y, direction.x);\n"
+    "    int index = CORNERS[corner];\n"
+    "    vec2 end = index % 2 == 0 ? a : b;\n"
+    "    vec2 offset = (index % 2 == 0 ? -direction : direction) +\n"
+    "                  (index < 2 ? -normal : normal);\n"
+    "    return end + offset * width / viewportSize;\n"
+    "}\n"
     "void main() {\n"
-    "    mat3 position = mat3(position3x2);\n"
-    "    mat3 view = mat3(view3x2);\n"
-    "    vec3 pos = view * position * vec3(points, 1.0);\n"
-    "    gl_Position = vec4(pos.xy * windowSize, 0.0, 1.0);\n"
+    "    vec2 point = vec2(0.0);\n"
+    "    if (nbSides == 0) {\n"
+    "        mat3 view = position2.y > 0.0 ? mat3(1.0) : mat3(view3x2);\n"
+    "        vec2 a = (view * vec3(position0, 1.0)).xy * windowSize;\n"
+    "        vec2 b = (view * vec3(position1, 1.0)).xy * windowSize;\n"
+    "        point = lineCorner(a, b, position2.x, gl_VertexID % 6);\n"
+    "    } else if (outlineWidth > 0.0) {\n"
+    "        int side = gl_VertexID / 6;\n"
+    "        point = lineCorner(instanceVertex(side + 1),\n"
+    "                           instanceVertex(side + 2), outlineWidth,\n"
+    "                           gl_VertexID % 6);\n"
+    "    } else {\n"
+    "        point = instanceVertex(gl_VertexID);\n"
+    "    }\n"
+    "    gl_Position = vec4(point, 0.0, 1.0);\n"
+    "    vertexColor = instanceColor;\n"
     "}\n";
 
-/// @brief Color fragment using uniform vec3 `color`.
+/// @brief Color fragment using the instance color, or uniform vec3 `color`
+/// if `useInstanceColor` is false.
 static const char* minimalFragmentShader =
     "#version 330 core\n"
+    "in vec3 vertexColor;\n"
     "uniform vec3 color;\n"
+    "uniform bool useInstanceColor;\n"
+    "out vec4 fragmentColor;\n"
     "void main() {\n"
-    "    gl_FragColor = vec4(color, 1.0);\n"
+    "    fragmentColor = vec4(useInstanceColor ? vertexColor : color, 1.0);\n"
     "}\n";
 
-bool createMinimalProgram(unsigned& program) {
+/// @brief Compile and link a program from shader sources, or load it from
+/// the program cache.
+/// @param vertexSource
+/// @param fragmentSource
+/// @param program
+/// @return whether the program is ready to use, errors are logged
+static bool createProgram(const char* vertexSource, const char* fragmentSource,
+                          unsigned& program) {
+    const auto start = std::chrono::steady_clock::now();
+    auto seconds = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             start)
+            .count();
+    };
+    const std::string sources = std::string(vertexSource) + fragmentSource;
+    if (loadCachedProgram(sources, program)) {
+        std::clog << "Program loaded from cache in " << seconds() << "s."
+                  << std::endl;
+        return true;
+    }
+
     // create vertex shader
     unsigned vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &minimalVertexShader, NULL);
+    glShaderSource(vertexShader, 1, &vertexSource, NULL);
     glCompileShader(vertexShader);
 
     int success;
@@ -45,7 +194,7 @@ bool createMinimalProgram(unsigned& program) {
 
     // create fragment shader
     unsigned fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &minimalFragmentShader, NULL);
+    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
     glCompileShader(fragmentShader);
 
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
@@ -60,6 +209,7 @@ bool createMinimalProgram(unsigned& program) {
     program = glCreateProgram();
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
+    prepareCachedProgram(program);
     glLinkProgram(program);
 
     glGetProgramiv(program, GL_LINK_STATUS, &success);
@@ -71,5 +221,17 @@ bool createMinimalProgram(unsigned& program) {
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+    storeCachedProgram(sources, program);
+    std::clog << "Program compiled in " << seconds() << "s." << std::endl;
     return true;
 }
+
+/// @brief Create the program drawing polygon and segment instances.
+/// @param program
+/// @param getProcAddress loader of the current context, for the program
+/// cache
+/// @return whether the program is ready to use, errors are logged
+bool createMinimalProgram(unsigned& program, GLADloadproc getProcAddress) {
+    initProgramCache(getProcAddress);
+    return createProgram(minimalVertexShader, minimalFragmentShader, program);
+}
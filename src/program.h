@@ -1,6 +1,8 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
-bool createMinimalProgram(unsigned& program);
+#include <glad/glad.h>
+
+bool createMinimalProgram(unsigned& program, GLADloadproc getProcAddress);
 
 #endif /* PROGRAM_H */
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "programCache.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <glad/glad.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+// OpenGL 4.1 or GL_ARB_get_program_binary, missing from the 3.3 GLAD loader
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void(APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize,
+                                             GLsizei* length,
+                                             GLenum* binaryFormat,
+                                             void* binary);
+typedef void(APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat,
+                                          const void* binary, GLsizei length);
+typedef void(APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname,
+                                              GLint value);
+
+// larger binaries are corrupted files
+static const std::uint32_t MAX_BINARY_SIZE = 1 << 26;
+
+static GetProgramBinaryProc getProgramBinary = nullptr;
+static ProgramBinaryProc programBinary = nullptr;
+static ProgramParameteriProc programParameteri = nullptr;
+// whether the current context can save and load program binaries
+static bool supported = false;
+
+static bool hasExtension(const char* name) {
+    int nbExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &nbExtensions);
+    for (int n = 0; n < nbExtensions; n++) {
+        const char* extension =
+            reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, n));
+        if (extension && !std::strcmp(extension, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Load the program binary entry points of the current context.
+/// @param getProcAddress loader of the context, the one given to GLAD
+/// (`glfwGetProcAddress` or `eglGetProcAddress`)
+void initProgramCache(GLADloadproc getProcAddress) {
+    supported = false;
+    bool version41 = GLVersion.major > 4 ||
+                     (GLVersion.major == 4 && GLVersion.minor >= 1);
+    if (!version41 && !hasExtension("GL_ARB_get_program_binary")) {
+        return;
+    }
+    getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(
+        getProcAddress("glGetProgramBinary"));
+    programBinary =
+        reinterpret_cast<ProgramBinaryProc>(getProcAddress("glProgramBinary"));
+    programParameteri = reinterpret_cast<ProgramParameteriProc>(
+        getProcAddress("glProgramParameteri"));
+    int nbFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nbFormats);
+    supported =
+        getProgramBinary && programBinary && programParameteri && nbFormats;
+}
+
+static std::string glString(const GLenum name) {
+    const GLubyte* string = glGetString(name);
+    return string ? reinterpret_cast<const char*>(string) : "";
+}
+
+/// @brief Identify the driver and the shader sources of a program.
+static std::string cacheKey(const std::string& sources) {
+    return glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' +
+           glString(GL_VERSION) + '\n' + sources;
+}
+
+/// @brief 64-bit FNV-1a hash, stable across runs and platforms.
+static std::uint64_t hash(const std::string& key) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// @brief Cache directory, `$XDG_CACHE_HOME/tiling` or `~/.cache/tiling`,
+/// created if needed.
+static std::string cacheDirectory() {
+    std::string directory{};
+    if (const char* cacheHome = std::getenv("XDG_CACHE_HOME")) {
+        directory = cacheHome;
+    } else if (const char* home = std::getenv("HOME")) {
+        directory = std::string(home) + "/.cache";
+        mkdir(directory.data(), 0755);
+    } else {
+        directory = ".";
+    }
+    directory += "/tiling";
+    mkdir(directory.data(), 0755);
+    return directory;
+}
+
+static std::string cacheFilename(const std::string& key) {
+    std::ostringstream filename{};
+    filename << cacheDirectory() << "/program_" << std::hex << hash(key)
+             << ".bin";
+    return filename.str();
+}
+
+/// @brief Create `program` from the binary cached for `sources`.
+/// @param sources concatenated sources of the shaders of the program
+/// @param program created and linked if found, unchanged otherwise
+/// @return whether a valid binary was found for the current driver
+bool loadCachedProgram(const std::string& sources, unsigned& program) {
+    if (!supported) {
+        return false;
+    }
+    const std::string key = cacheKey(sources);
+    std::ifstream file(cacheFilename(key), std::ios::binary);
+    char magic[4] = {};
+    std::uint32_t header[3] = {};
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::strncmp(magic, "TPC1", 4) || header[0] != key.size() ||
+        header[2] > MAX_BINARY_SIZE) {
+        return false;
+    }
+    // the whole key guards against hash collisions
+    std::string fileKey(header[0], '\0');
+    std::vector<char> binary(header[2]);
+    file.read(&fileKey[0], fileKey.size());
+    file.read(binary.data(), binary.size());
+    if (!file || fileKey != key) {
+        return false;
+    }
+
+    unsigned cachedProgram = glCreateProgram();
+    programBinary(cachedProgram, header[1], binary.data(), binary.size());
+    int success;
+    glGetProgramiv(cachedProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        // rejected by the driver, recompile
+        glDeleteProgram(cachedProgram);
+        return false;
+    }
+    program = cachedProgram;
+    return true;
+}
+
+/// @brief Allow retrieving the binary of `program`, call before linking.
+void prepareCachedProgram(const unsigned program) {
+    if (supported) {
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                          GL_TRUE);
+    }
+}
+
+/// @brief Save the binary of the linked `program` for the next launch.
+/// @param sources concatenated sources of the shaders of the program
+/// @param program
+void storeCachedProgram(const std::string& sources, const unsigned program) {
+    if (!supported) {
+        return;
+    }
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(program, length, &length, &format, binary.data());
+
+    const std::string key = cacheKey(sources);
+    std::ofstream file(cacheFilename(key), std::ios::binary);
+    std::uint32_t header[3] = {static_cast<std::uint32_t>(key.size()), format,
+                               static_cast<std::uint32_t>(length)};
+    file.write("TPC1", 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(key.data(), key.size());
+    file.write(binary.data(), length);
+}
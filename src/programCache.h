@@ -0,0 +1,20 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+#include <string>
+
+/// @brief On-disk cache of linked shader program binaries.
+///
+/// Binaries are keyed by the OpenGL vendor, renderer and version strings and
+/// by the shader sources, so a driver update or a shader change compiles the
+/// program again. The cache is silently disabled if the context supports
+/// neither OpenGL 4.1 nor `GL_ARB_get_program_binary`, or until
+/// `initProgramCache` is called.
+
+void initProgramCache(GLADloadproc getProcAddress);
+bool loadCachedProgram(const std::string& sources, unsigned& program);
+void prepareCachedProgram(const unsigned program);
+void storeCachedProgram(const std::string& sources, const unsigned program);
+
+#endif /* PROGRAM_CACHE_H */
@@ -0,0 +1,354 @@
+#include "renderer.h"
+#include "program.h"
+#include "utils.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+
+using namespace glm;
+
+// half the size of the crosshair, in the units of `windowSize`
+static const float CROSSHAIR_SIZE = 0.03;
+// widths of the lines in pixels
+static const float OUTLINE_WIDTH = 1.0;
+static const float BOUNDARY_WIDTH = 3.0;
+static const float CURSOR_WIDTH = 5.0;
+static const float CROSSHAIR_WIDTH = 1.0;
+// segments drawn after the boundary in interactive views: the cursor then
+// the crosshair
+static const int NB_INTERACTIVE_SEGMENTS = 3;
+// distance in pixels between the origin of the view and the window center
+// beyond which the origin is moved
+static const float RECENTER_PIXELS = 4096.0;
+
+/// @brief Draw into `width` x `height` pixels.
+void View::resize(const int width, const int height) {
+    float smallerSide = std::max(std::min(width, height), 1);
+    this->width = width;
+    this->height = height;
+    windowSize = vec2(smallerSide / std::max(width, 1),
+                      smallerSide / std::max(height, 1));
+}
+
+/// @brief Plane position drawn at `point`, inverting the vertex shader
+/// transformation.
+/// @param point normalized device coordinates, (0, 0) being the window center
+dvec2 View::unproject(const vec2& point) const {
+    mat2 view = mat2(viewMatrix[0], viewMatrix[1]);
+    return origin + dvec2(inverse(view) * (point / windowSize - viewMatrix[2]));
+}
+
+/// @brief Compute the bounding box of the visible part of the plane.
+/// @param min lower left corner
+/// @param max upper right corner
+void View::getVisibleBounds(dvec2& min, dvec2& max) const {
+    min = dvec2(INFINITY);
+    max = dvec2(-INFINITY);
+    for (float x = -1.0; x <= 1.0; x += 2.0) {
+        for (float y = -1.0; y <= 1.0; y += 2.0) {
+            dvec2 corner = unproject(vec2(x, y));
+            min = glm::min(min, corner);
+            max = glm::max(max, corner);
+        }
+    }
+}
+
+/// @brief Size of a pixel on the plane, which only depends on the zoom.
+float View::getPixelSize() const {
+    float smallerSide = std::max(std::min(width, height), 1);
+    return 2.0f / (smallerSide * length(viewMatrix[0]));
+}
+
+/// @brief Move `origin` to the window center if it is more than
+/// `RECENTER_PIXELS` away, without changing what is drawn.
+/// @return whether `origin` moved
+bool View::recenter() {
+    mat2 view = mat2(viewMatrix[0], viewMatrix[1]);
+    vec2 center = inverse(view) * -viewMatrix[2];
+    if (length(center) < RECENTER_PIXELS * getPixelSize()) {
+        return false;
+    }
+    origin += dvec2(center);
+    viewMatrix[2] = vec2(0.0);
+    return true;
+}
+
+/// @brief Create the program and buffers in the current context.
+/// @param getProcAddress loader of the context, the one given to GLAD
+Renderer::Renderer(GLADloadproc getProcAddress) {
+    assert(createMinimalProgram(shaderProgram, getProcAddress));
+    initGL();
+    log(" was " GREEN "created" RESET ".");
+}
+
+Renderer::~Renderer() {
+    destroyGL();
+    log(" was " RED "deleted" RESET ".");
+}
+
+/// @brief Draw `scene` as seen from `view`: polygons with a black outline,
+/// edges accessible to the cursor underlined, and if `view` is interactive
+/// the cursor highlighted and a crosshair at the center of the window.
+/// Only chunks of polygons whose bounding box is visible are drawn, one
+/// instanced call per run of contiguous visible chunks, then the segments
+/// in a single instanced call.
+/// @param scene
+/// @param view
+void Renderer::render(const Scene& scene, const View& view) {
+    upload(scene);
+    glViewport(0, 0, view.width, view.height);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // positions in the scene are relative to its own origin, the difference
+    // between both origins is small near the camera
+    mat3x2 viewMatrix = view.viewMatrix;
+    viewMatrix[2] += mat2(viewMatrix[0], viewMatrix[1]) *
+                     vec2(scene.origin - view.origin);
+    glUseProgram(shaderProgram);
+    int viewUniform = glGetUniformLocation(shaderProgram, "view3x2");
+    glUniformMatrix3x2fv(viewUniform, 1, GL_FALSE, value_ptr(viewMatrix));
+    int sizeUniform = glGetUniformLocation(shaderProgram, "windowSize");
+    glUniform2fv(sizeUniform, 1, value_ptr(view.windowSize));
+    glUniform2f(viewportSizeUniform, std::max(view.width, 1),
+                std::max(view.height, 1));
+
+    dvec2 visibleMin, visibleMax;
+    view.getVisibleBounds(visibleMin, visibleMax);
+    vec2 min = vec2(visibleMin - scene.origin);
+    vec2 max = vec2(visibleMax - scene.origin);
+    glBindVertexArray(polygonVao);
+    // visible neighbors are drawn together, unless unused instances
+    // separate them
+    int first = 0, count = 0, nbSides = 0;
+    for (auto& chunk : scene.chunks) {
+        if (chunk.min.x > max.x || chunk.min.y > max.y || chunk.max.x < min.x ||
+            chunk.max.y < min.y) {
+            drawInstances(first, count, nbSides);
+            count = 0;
+            nbSides = 0;
+            continue;
+        }
+        if (count > 0 && chunk.first != first + count) {
+            drawInstances(first, count, nbSides);
+            count = 0;
+            nbSides = 0;
+        }
+        if (count == 0) {
+            first = chunk.first;
+        }
+        count += chunk.count;
+        nbSides = std::max(nbSides, chunk.nbSides);
+    }
+    drawInstances(first, count, nbSides);
+
+    glBindVertexArray(segmentVao);
+    glUniform1i(useInstanceColorUniform, GL_TRUE);
+    int nbSegments = scene.boundary.size() / 2;
+    if (view.interactive) {
+        nbSegments += NB_INTERACTIVE_SEGMENTS;
+    }
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, nbSegments);
+    // the draw calls reading the streamed instances were issued
+    streaming.endFrame();
+}
+
+void Renderer::log(const char* log) const {
+    std::clog << "Renderer" << log << std::endl;
+}
+
+void Renderer::initGL() {
+    colorUniform = glGetUniformLocation(shaderProgram, "color");
+    useInstanceColorUniform =
+        glGetUniformLocation(shaderProgram, "useInstanceColor");
+    viewportSizeUniform = glGetUniformLocation(shaderProgram, "viewportSize");
+    outlineWidthUniform = glGetUniformLocation(shaderProgram, "outlineWidth");
+
+    glGenBuffers(1, &instanceVbo);
+    glGenBuffers(1, &segmentVbo);
+    glGenVertexArrays(1, &polygonVao);
+    glGenVertexArrays(1, &segmentVao);
+    for (unsigned vao : {polygonVao, segmentVao}) {
+        glBindVertexArray(vao);
+        for (int attribute = 1; attribute <= 5; attribute++) {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+    }
+    // segments are always drawn from the first one
+    setInstanceAttributes(segmentVbo, 0);
+}
+
+void Renderer::destroyGL() {
+    glDeleteVertexArrays(1, &polygonVao);
+    glDeleteVertexArrays(1, &segmentVao);
+    glDeleteBuffers(1, &segmentVbo);
+    glDeleteBuffers(1, &instanceVbo);
+    if (shaderProgram) {
+        glDeleteProgram(shaderProgram);
+    }
+}
+
+/// @brief Point the instance attributes of the bound VAO to the instances
+/// of `vbo` starting at `first`.
+void Renderer::setInstanceAttributes(const unsigned vbo,
+                                     const int first) const {
+    const std::size_t stride = sizeof(PolygonInstance);
+    const std::size_t offset = first * stride;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    for (int column = 0; column < 3; column++) {
+        glVertexAttribPointer(
+            1 + column, 2, GL_FLOAT, GL_FALSE, stride,
+            (const void*)(offset + column * sizeof(glm::vec2)));
+    }
+    glVertexAttribPointer(
+        4, 3, GL_FLOAT, GL_FALSE, stride,
+        (const void*)(offset + offsetof(PolygonInstance, color)));
+    glVertexAttribIPointer(
+        5, 1, GL_INT, stride,
+        (const void*)(offset + offsetof(PolygonInstance, nbSides)));
+}
+
+/// @brief Draw `count` instances starting at `first`, filled then outlined.
+/// @param first
+/// @param count
+/// @param nbSides maximum number of outline vertices of the instances
+void Renderer::drawInstances(const int first, const int count,
+                             const int nbSides) const {
+    if (count == 0) {
+        return;
+    }
+    setInstanceAttributes(instanceVbo, first);
+    glUniform1i(useInstanceColorUniform, GL_TRUE);
+    glUniform1f(outlineWidthUniform, 0.0);
+    // from the center around to the first vertex again
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, nbSides + 2, count);
+    glUniform1i(useInstanceColorUniform, GL_FALSE);
+    glUniform3f(colorUniform, 0.0, 0.0, 0.0);
+    // two triangles per side
+    glUniform1f(outlineWidthUniform, OUTLINE_WIDTH);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6 * nbSides, count);
+}
+
+/// @brief Upload what changed in `scene` since the last frame: nothing if
+/// it is the same version, else the instances if their key changed, then
+/// the segments.
+/// Instances of a new revision of the same tiling at the same origin are
+/// updated in place if possible, the others replace the instance buffer.
+void Renderer::upload(const Scene& scene) {
+    if (uploaded && scene.version == uploadedVersion) {
+        return;
+    }
+    if (!uploaded || scene.instancesKey != uploadedInstances) {
+        if (!uploaded || !updateInstances(scene)) {
+            uploadInstances(scene);
+        }
+    }
+    uploadSegments(scene);
+    uploaded = true;
+    uploadedVersion = scene.version;
+}
+
+/// @brief Replace the instance buffer, orphaning the previous data store
+/// which frames in flight may still read.
+void Renderer::uploadInstances(const Scene& scene) {
+    instanceBytes = sizeof(PolygonInstance) * scene.instances.size();
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, instanceBytes, scene.instances.data(),
+                 GL_DYNAMIC_DRAW);
+    uploadedInstances = scene.instancesKey;
+    uploadedOffsets = scene.groupOffsets;
+    uploadedCounts = scene.groupCounts;
+}
+
+/// @brief Stream the instances changed by the revisions of the tiling since
+/// the uploaded one into the instance buffer, falling back to
+/// `glBufferSubData` when the streaming buffer is full for this frame.
+///
+/// In each group, the instances from the first one changed by these
+/// revisions to the last one used before or after them are uploaded: the
+/// unused instances are zero.
+/// @return false, uploading nothing, if the instances aren't a later
+/// revision of the same tiling at the same origin with the same groups, or
+/// if the scene doesn't know all the revisions since the uploaded one
+bool Renderer::updateInstances(const Scene& scene) {
+    const unsigned revision = uploadedInstances.revision;
+    if (scene.instancesKey.source != uploadedInstances.source ||
+        scene.instancesKey.origin != uploadedInstances.origin ||
+        scene.instancesKey.revision <= revision ||
+        scene.groupOffsets.empty() || scene.groupOffsets != uploadedOffsets ||
+        scene.changes.empty() ||
+        scene.changes.front().revision > revision + 1) {
+        return false;
+    }
+    const std::size_t stride = sizeof(PolygonInstance);
+    for (std::size_t group = 0; group < scene.groupCounts.size(); group++) {
+        int first = scene.groupOffsets[group + 1];
+        for (auto& change : scene.changes) {
+            if (change.revision > revision) {
+                first = std::min(first, change.firstInstances[group]);
+            }
+        }
+        const int end =
+            scene.groupOffsets[group] +
+            std::max(scene.groupCounts[group], uploadedCounts[group]);
+        if (first >= end) {
+            continue;
+        }
+        const void* data = &scene.instances[first];
+        const std::size_t bytes = (end - first) * stride;
+        if (!streaming.write(instanceVbo, first * stride, data, bytes)) {
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+            glBufferSubData(GL_ARRAY_BUFFER, first * stride, bytes, data);
+        }
+    }
+    uploadedInstances = scene.instancesKey;
+    uploadedCounts = scene.groupCounts;
+    return true;
+}
+
+/// @brief Instance of a segment from `a` to `b`, `width` pixels wide.
+/// @param window whether `a` and `b` are in the units of `windowSize`
+/// rather than on the plane
+static PolygonInstance segmentInstance(const vec2& a, const vec2& b,
+                                       const vec3& color, const float width,
+                                       const bool window = false) {
+    PolygonInstance segment{};
+    segment.modelMatrix = mat3x2(a, b, vec2(width, window ? 1.0 : 0.0));
+    segment.color = color;
+    return segment;
+}
+
+/// @brief Upload the boundary, the cursor and the crosshair, in the order
+/// they are drawn.
+void Renderer::uploadSegments(const Scene& scene) {
+    std::vector<PolygonInstance> segments{};
+    segments.reserve(scene.boundary.size() / 2 + NB_INTERACTIVE_SEGMENTS);
+    for (std::size_t n = 0; n + 1 < scene.boundary.size(); n += 2) {
+        segments.push_back(segmentInstance(scene.boundary[n],
+                                           scene.boundary[n + 1], vec3(0.0),
+                                           BOUNDARY_WIDTH));
+    }
+    segments.push_back(segmentInstance(scene.cursorA, scene.cursorB,
+                                       cursorColor(), CURSOR_WIDTH));
+    // the crosshair doesn't move with the view
+    segments.push_back(segmentInstance(vec2(-CROSSHAIR_SIZE, 0.0),
+                                       vec2(CROSSHAIR_SIZE, 0.0), vec3(0.0),
+                                       CROSSHAIR_WIDTH, true));
+    segments.push_back(segmentInstance(vec2(0.0, -CROSSHAIR_SIZE),
+                                       vec2(0.0, CROSSHAIR_SIZE), vec3(0.0),
+                                       CROSSHAIR_WIDTH, true));
+    segmentBytes = sizeof(segments[0]) * segments.size();
+    glBindBuffer(GL_ARRAY_BUFFER, segmentVbo);
+    glBufferData(GL_ARRAY_BUFFER, segmentBytes, segments.data(),
+                 GL_DYNAMIC_DRAW);
+}
+
+/// @brief Bytes uploaded to the GPU for the current scene.
+std::size_t Renderer::getBufferBytes() const {
+    return instanceBytes + segmentBytes;
+}
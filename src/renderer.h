@@ -0,0 +1,100 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "scene.h"
+#include "streamingBuffer.h"
+#include <cstddef>
+#include <glad/glad.h>
+#include <glm/mat3x2.hpp>
+#include <glm/vec2.hpp>
+#include <vector>
+
+/// @brief Camera and window state used to draw a Scene.
+///
+/// The camera has a floating origin: `viewMatrix` applies to positions
+/// relative to `origin`, which `recenter` moves to the window center once
+/// the view has drifted away from it, so that its translation stays small
+/// enough for float precision wherever the camera goes.
+struct View {
+    glm::mat3x2 viewMatrix{1.0};
+    glm::dvec2 origin{};
+    // scales the shortest window side to [-1, 1]
+    glm::vec2 windowSize{1.0, 1.0};
+    int width{};
+    int height{};
+    // whether to draw the crosshair and the edge cursor, which only make
+    // sense in a window
+    bool interactive = true;
+
+    void resize(const int width, const int height);
+    glm::dvec2 unproject(const glm::vec2& point) const;
+    void getVisibleBounds(glm::dvec2& min, glm::dvec2& max) const;
+    float getPixelSize() const;
+    bool recenter();
+};
+
+/// @brief Draws Scene instances with an OpenGL shader program. Non-copyable.
+/// Must be created, used and destroyed on the thread owning the OpenGL
+/// context.
+///
+/// Polygons have no vertex buffer: the vertex shader generates their
+/// vertices from the instance attributes, so each run of consecutive visible
+/// chunks is drawn by a single instanced call whatever the numbers of sides.
+/// Outlines and segments are quads of triangles generated the same way, so
+/// their width in pixels doesn't depend on the `glLineWidth` of the driver.
+/// Building a scene is CPU work only: its changes are uploaded in one step
+/// at the start of the next frame, the instance buffer only when the
+/// instances changed rather than on every new version of the scene. Scenes
+/// of a tiling know which instances its last revisions changed, and only
+/// those ranges are streamed, so adding a polygon to a large tiling uploads
+/// a few dozen bytes.
+class Renderer {
+    unsigned shaderProgram{};
+    int colorUniform{};
+    int useInstanceColorUniform{};
+    int viewportSizeUniform{};
+    int outlineWidthUniform{};
+    // instance buffer in attributes 1 to 5
+    unsigned polygonVao{};
+    unsigned instanceVbo{};
+    // segments as instances in attributes 1 to 5: boundary, cursor then
+    // crosshair
+    unsigned segmentVao{};
+    unsigned segmentVbo{};
+    bool uploaded = false;
+    unsigned uploadedVersion{};
+    InstancesKey uploadedInstances{};
+    // groups of the uploaded instances, see Scene
+    std::vector<int> uploadedOffsets{};
+    std::vector<int> uploadedCounts{};
+    StreamingBuffer streaming{};
+    // bytes of the data stores of the buffers
+    std::size_t instanceBytes{};
+    std::size_t segmentBytes{};
+
+    void log(const char* log) const;
+    void initGL();
+    void destroyGL();
+    void setInstanceAttributes(const unsigned vbo, const int first) const;
+    void drawInstances(const int first, const int count,
+                       const int nbSides) const;
+    void upload(const Scene& scene);
+    void uploadInstances(const Scene& scene);
+    bool updateInstances(const Scene& scene);
+    void uploadSegments(const Scene& scene);
+
+  public:
+    Renderer(GLADloadproc getProcAddress);
+    ~Renderer();
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+    void render(const Scene& scene, const View& view);
+    std::size_t getBufferBytes() const;
+};
+
+static_assert(!std::is_copy_constructible<Renderer>::value,
+              "Renderer shouldn't be copy constructible.");
+static_assert(!std::is_copy_assignable<Renderer>::value,
+              "Renderer shouldn't be copy assignable.");
+
+#endif /* RENDERER_H */
@@ -0,0 +1,307 @@
+#include "scene.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+// number of instances sharing a bounding box
+static const int CHUNK_SIZE = 1024;
+
+/// @brief Revision of sources without one, different at each call.
+static unsigned nextRevision() {
+    static std::atomic<unsigned> revision{0};
+    return ++revision;
+}
+
+bool operator==(const InstancesKey& lhs, const InstancesKey& rhs) {
+    return lhs.source == rhs.source && lhs.revision == rhs.revision &&
+           lhs.origin == rhs.origin;
+}
+
+bool operator!=(const InstancesKey& lhs, const InstancesKey& rhs) {
+    return !(lhs == rhs);
+}
+
+/// @brief Instances reserved for `count` polygons with the same number of
+/// sides: `CHUNK_SIZE` doubled as needed, so that a group rarely grows.
+static int getGroupCapacity(const int count) {
+    int capacity = CHUNK_SIZE;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+/// @brief Replace the instances and chunks with the polygons of `tiling`,
+/// relative to `origin`.
+///
+/// Polygons are grouped by number of sides, in the order of their ids, and
+/// each group has unused instances after its polygons: adding or removing
+/// the last polygons only changes their own instances, which the renderer
+/// uploads alone. Unused instances are zero and outside every chunk.
+///
+/// The last changes of `tiling` are translated to the first instance they
+/// changed in each group: the instance of the first polygon of the group
+/// they changed, or the end of the polygons of the group.
+void Scene::captureInstances(const Tiling& tiling) {
+    const auto& polygons = tiling.getPolygons();
+    const WorldGeometry& geometry = tiling.getGeometry();
+
+    // counting sort of the polygons by number of sides, into groups
+    std::vector<int>& counts = groupCounts;
+    counts.clear();
+    for (auto& polygon : polygons) {
+        if (static_cast<int>(counts.size()) <= polygon->nbSides) {
+            counts.resize(polygon->nbSides + 1, 0);
+        }
+        counts[polygon->nbSides]++;
+    }
+    std::vector<int>& offsets = groupOffsets;
+    offsets.assign(counts.size() + 1, 0);
+    for (std::size_t n = 0; n < counts.size(); n++) {
+        offsets[n + 1] =
+            offsets[n] + (counts[n] ? getGroupCapacity(counts[n]) : 0);
+    }
+    instances.assign(offsets.back(), PolygonInstance{});
+    chunks.clear();
+    // index of the first chunk of each group
+    std::vector<int> firstChunks(counts.size(), 0);
+    for (std::size_t nbSides = 0; nbSides < counts.size(); nbSides++) {
+        firstChunks[nbSides] = chunks.size();
+        for (int n = 0; n < counts[nbSides]; n += CHUNK_SIZE) {
+            chunks.emplace_back(nbSides, offsets[nbSides] + n, vec2(INFINITY),
+                                vec2(-INFINITY));
+            chunks.back().count = std::min(CHUNK_SIZE, counts[nbSides] - n);
+        }
+    }
+    // rank of the polygons in their group
+    std::vector<int> ranks(counts.size(), 0);
+
+    const auto& tilingChanges = tiling.getChanges();
+    changes.clear();
+    for (auto& change : tilingChanges) {
+        changes.emplace_back(change.revision);
+    }
+    // changes not translated yet, by decreasing first id
+    std::vector<int> pending(changes.size());
+    for (std::size_t n = 0; n < pending.size(); n++) {
+        pending[n] = n;
+    }
+    std::sort(pending.begin(), pending.end(), [&](const int a, const int b) {
+        return tilingChanges[a].firstId > tilingChanges[b].firstId;
+    });
+    // the changes from polygon `id` on start at the next instance of each
+    // group
+    auto translateChanges = [&](const int id) {
+        while (!pending.empty() &&
+               tilingChanges[pending.back()].firstId <= id) {
+            auto& firstInstances = changes[pending.back()].firstInstances;
+            firstInstances.resize(counts.size());
+            for (std::size_t n = 0; n < counts.size(); n++) {
+                firstInstances[n] = offsets[n] + ranks[n];
+            }
+            pending.pop_back();
+        }
+    };
+    for (auto& polygon : polygons) {
+        translateChanges(polygon->getId());
+        const int rank = ranks[polygon->nbSides]++;
+        PolygonInstance& instance = instances[offsets[polygon->nbSides] + rank];
+        dmat3x2 modelMatrix = polygon->getModelMatrix();
+        modelMatrix[2] -= origin;
+        instance.modelMatrix = mat3x2(modelMatrix);
+        instance.color =
+            getColor(static_cast<PolygonColor>(polygon->getColorIndex()));
+        instance.nbSides = polygon->nbSides;
+        dvec2 worldMin, worldMax;
+        geometry.getBounds(polygon->getId(), worldMin, worldMax);
+        InstanceChunk& chunk =
+            chunks[firstChunks[polygon->nbSides] + rank / CHUNK_SIZE];
+        chunk.min = glm::min(chunk.min, vec2(worldMin - origin));
+        chunk.max = glm::max(chunk.max, vec2(worldMax - origin));
+    }
+    translateChanges(INT_MAX);
+}
+
+/// @brief Replace the content of the scene with `tiling`, reusing the
+/// storage of the previous content. The instances are kept if they were
+/// captured from the same revision of `tiling` and the same origin, e.g.
+/// when only the cursor moved.
+/// @param tiling
+/// @param origin new origin of the positions, in double precision like the
+/// polygons
+void Scene::capture(const Tiling& tiling, const dvec2& origin) {
+    this->origin = origin;
+    const WorldGeometry& geometry = tiling.getGeometry();
+    const InstancesKey key{&tiling, tiling.getRevision(), origin};
+    if (key != instancesKey) {
+        captureInstances(tiling);
+        instancesKey = key;
+    }
+    boundary.clear();
+    for (auto& edge : tiling.getEdges()) {
+        int id = edge.polygon->getId();
+        boundary.push_back(vec2(geometry.getVertex(id, edge.edge) - origin));
+        boundary.push_back(
+            vec2(geometry.getVertex(id, edge.edge + 1) - origin));
+    }
+    if (tiling.getCurrentEdge()) {
+        const Edge& edge = *tiling.getCurrentEdge();
+        int id = edge.polygon->getId();
+        cursorA = vec2(geometry.getVertex(id, edge.edge) - origin);
+        cursorB = vec2(geometry.getVertex(id, edge.edge + 1) - origin);
+    } else {
+        // where the first polygon will be created
+        cursorA = vec2(dvec2(0.0, 0.0) - origin);
+        cursorB = vec2(dvec2(0.2, 0.0) - origin);
+    }
+}
+
+/// @brief Replace the content of the scene with the prototiles of `patch`,
+/// without boundary nor cursor.
+/// @param patch
+/// @param origin new origin of the positions, like for a Tiling
+void Scene::capture(const SubstitutionTiling& patch, const dvec2& origin) {
+    this->origin = origin;
+    instancesKey = InstancesKey{&patch, nextRevision(), origin};
+    groupOffsets.clear();
+    groupCounts.clear();
+    changes.clear();
+    // colors of the prototile types
+    static const PolygonColor colors[] = {yellow, darkBlue, lightBlue, pink};
+    const auto& tiles = patch.getTiles();
+    instances.resize(tiles.size());
+    chunks.clear();
+    for (std::size_t n = 0; n < tiles.size(); n++) {
+        const Prototile& tile = tiles[n];
+        const vec2 tileOrigin = vec2(tile.origin - origin);
+        // maps the unit square generated for 4 sides to the parallelogram
+        instances[n].modelMatrix = mat3x2(tile.u, tile.v, tileOrigin);
+        instances[n].color = getColor(colors[tile.type]);
+        instances[n].nbSides = 4;
+        vec2 opposite = tileOrigin + tile.u + tile.v;
+        vec2 min = glm::min(glm::min(tileOrigin, opposite),
+                            tileOrigin + glm::min(tile.u, tile.v));
+        vec2 max = glm::max(glm::max(tileOrigin, opposite),
+                            tileOrigin + glm::max(tile.u, tile.v));
+        if (chunks.empty() || chunks.back().count == CHUNK_SIZE) {
+            chunks.emplace_back(4, n, min, max);
+        }
+        InstanceChunk& chunk = chunks.back();
+        chunk.count++;
+        chunk.min = glm::min(chunk.min, min);
+        chunk.max = glm::max(chunk.max, max);
+    }
+    boundary.clear();
+    cursorA = vec2(0.0, 0.0);
+    cursorB = vec2(0.0, 0.0);
+}
+
+/// @brief Replace the content of the scene with the tiles of `hyperbolic`,
+/// with the boundary of the Poincaré disk and without cursor.
+/// @param hyperbolic
+void Scene::capture(const HyperbolicTiling& hyperbolic) {
+    origin = dvec2(0.0);
+    instancesKey = InstancesKey{&hyperbolic, nextRevision(), origin};
+    groupOffsets.clear();
+    groupCounts.clear();
+    changes.clear();
+    const auto& tiles = hyperbolic.getTiles();
+    const int p = hyperbolic.getP();
+    const float radius = hyperbolic.getRadius();
+    instances.resize(tiles.size());
+    chunks.clear();
+    for (std::size_t n = 0; n < tiles.size(); n++) {
+        const HyperbolicTile& tile = tiles[n];
+        instances[n].modelMatrix =
+            mat3x2(vec2(tile.a.real(), tile.a.imag()),
+                   vec2(tile.b.real(), tile.b.imag()), vec2(radius, 0.0));
+        instances[n].color =
+            getColor(static_cast<PolygonColor>(tile.color % NB_COLORS));
+        instances[n].nbSides = -p;
+        vec2 min(INFINITY), max(-INFINITY);
+        for (int vertex = 0; vertex < p; vertex++) {
+            std::complex<double> z = hyperbolic.getVertex(tile, vertex);
+            min = glm::min(min, vec2(z.real(), z.imag()));
+            max = glm::max(max, vec2(z.real(), z.imag()));
+        }
+        // sides are arcs, which may bulge out of the vertices
+        vec2 margin = 0.25f * (max - min);
+        if (chunks.empty() || chunks.back().count == CHUNK_SIZE) {
+            chunks.emplace_back(p * HYPERBOLIC_SUBDIVISIONS, n, min, max);
+        }
+        InstanceChunk& chunk = chunks.back();
+        chunk.count++;
+        chunk.min = glm::min(chunk.min, min - margin);
+        chunk.max = glm::max(chunk.max, max + margin);
+    }
+    boundary.clear();
+    const int segments = 256;
+    for (int n = 0; n < segments; n++) {
+        boundary.push_back(rotate(two_pi<float>() * n / segments));
+        boundary.push_back(rotate(two_pi<float>() * (n + 1) / segments));
+    }
+    cursorA = vec2(0.0, 0.0);
+    cursorB = vec2(0.0, 0.0);
+}
+
+/// @brief Replace the content of the scene with the chunks of `periodic`
+/// kept in memory, colored by number of sides, without boundary nor cursor.
+/// @param periodic
+/// @param origin new origin of the positions, like for a Tiling
+void Scene::capture(const PeriodicTiling& periodic, const dvec2& origin) {
+    this->origin = origin;
+    instancesKey = InstancesKey{&periodic, nextRevision(), origin};
+    groupOffsets.clear();
+    groupCounts.clear();
+    changes.clear();
+    instances.clear();
+    chunks.clear();
+    for (auto& entry : periodic.getChunks()) {
+        const PeriodicChunk& chunk = entry.second;
+        const vec2 offset = vec2(chunk.origin - origin);
+        // the few polygons of the motif, each drawn with its own sides
+        std::vector<int> sides{};
+        for (auto& tile : chunk.tiles) {
+            if (std::find(sides.begin(), sides.end(), tile.nbSides) ==
+                sides.end()) {
+                sides.push_back(tile.nbSides);
+            }
+        }
+        for (int nbSides : sides) {
+            bool first = true;
+            for (auto& tile : chunk.tiles) {
+                if (tile.nbSides != nbSides) {
+                    continue;
+                }
+                if (first || chunks.back().count == CHUNK_SIZE) {
+                    chunks.emplace_back(nbSides, instances.size(),
+                                        chunk.min + offset, chunk.max + offset);
+                    first = false;
+                }
+                chunks.back().count++;
+                instances.emplace_back();
+                instances.back().modelMatrix = tile.modelMatrix;
+                instances.back().modelMatrix[2] += offset;
+                instances.back().color = getColor(
+                    static_cast<PolygonColor>(nbSides % NB_COLORS));
+                instances.back().nbSides = nbSides;
+            }
+        }
+    }
+    boundary.clear();
+    cursorA = vec2(0.0, 0.0);
+    cursorB = vec2(0.0, 0.0);
+}
+
+/// @brief Number of instances in the chunks.
+std::size_t Scene::getNbPolygons() const {
+    std::size_t nbPolygons = 0;
+    for (auto& chunk : chunks) {
+        nbPolygons += chunk.count;
+    }
+    return nbPolygons;
+}
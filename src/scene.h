@@ -0,0 +1,100 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "hyperbolicTiling.h"
+#include "periodicTiling.h"
+#include "substitutionTiling.h"
+#include "tiling.h"
+#include <glm/mat3x2.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/// @brief Per-instance attributes of a polygon, as uploaded to the GPU.
+/// Hyperbolic tiles have -p sides and hold their Möbius transformation and
+/// the radius of the central tile instead of a model matrix.
+struct PolygonInstance {
+    glm::mat3x2 modelMatrix{};
+    glm::vec3 color{};
+    int nbSides{};
+};
+
+/// @brief Consecutive instances drawn if their bounding box is visible.
+struct InstanceChunk {
+    // maximum number of outline vertices of the instances: their number of
+    // sides, times HYPERBOLIC_SUBDIVISIONS for hyperbolic tiles
+    int nbSides{};
+    int first{};
+    int count{};
+    glm::vec2 min{};
+    glm::vec2 max{};
+    InstanceChunk(int nbSides, int first, const glm::vec2& min,
+                  const glm::vec2& max)
+        : nbSides(nbSides), first(first), min(min), max(max) {};
+};
+
+/// @brief Identifies the content of the instances of a Scene: scenes with
+/// equal keys have equal instances, whichever of the triple buffer they are.
+struct InstancesKey {
+    // what the instances were captured from
+    const void* source{};
+    // changes whenever the instances of the source change
+    unsigned revision{};
+    glm::dvec2 origin{};
+    InstancesKey() {};
+    InstancesKey(const void* source, const unsigned revision,
+                 const glm::dvec2& origin)
+        : source(source), revision(revision), origin(origin) {};
+};
+
+/// @brief Instances changed by a revision of the Tiling of a Scene: in each
+/// group, those from `firstInstances[group]` to the end of the group.
+struct InstancesChange {
+    unsigned revision{};
+    std::vector<int> firstInstances{};
+    InstancesChange(const unsigned revision) : revision(revision) {};
+};
+
+bool operator==(const InstancesKey& lhs, const InstancesKey& rhs);
+bool operator!=(const InstancesKey& lhs, const InstancesKey& rhs);
+
+/// @brief Copy of everything the renderer draws from a Tiling.
+///
+/// Scenes are captured on the edit thread and read on the render thread, so
+/// that neither waits for the other. Positions are relative to `origin`,
+/// usually near the camera, which keeps them precise in float far from
+/// (0, 0).
+struct Scene {
+    // sorted by number of sides, so that a draw call generates few vertices
+    // past the last vertex of its instances; those outside the chunks are
+    // unused
+    std::vector<PolygonInstance> instances{};
+    std::vector<InstanceChunk> chunks{};
+    // pairs of points, one pair per edge accessible to the cursor
+    std::vector<glm::vec2> boundary{};
+    glm::vec2 cursorA{0.0, 0.0};
+    glm::vec2 cursorB{0.2, 0.0};
+    glm::dvec2 origin{};
+    // the instances and chunks are only rebuilt, and uploaded, when it
+    // changes
+    InstancesKey instancesKey{};
+    // groups of the instances of a Tiling, indexed by number of sides: first
+    // instance of each group then the end of the last one, and instances
+    // used in each group. Empty for other sources.
+    std::vector<int> groupOffsets{};
+    std::vector<int> groupCounts{};
+    // what the last revisions of the Tiling changed, oldest first, so that
+    // the renderer only uploads those instances
+    std::vector<InstancesChange> changes{};
+    // set by the writer each time it publishes a scene, never reused
+    unsigned version{};
+
+    void captureInstances(const Tiling& tiling);
+    void capture(const Tiling& tiling, const glm::dvec2& origin);
+    void capture(const SubstitutionTiling& patch, const glm::dvec2& origin);
+    void capture(const HyperbolicTiling& hyperbolic);
+    void capture(const PeriodicTiling& periodic, const glm::dvec2& origin);
+    std::size_t getNbPolygons() const;
+};
+
+#endif /* SCENE_H */
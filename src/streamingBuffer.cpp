@@ -0,0 +1,87 @@
+#include "streamingBuffer.h"
+#include <cstring>
+#include <glad/glad.h>
+
+// regions of the staging buffer, at least the frames the driver may queue
+static const int NB_REGIONS = 4;
+// bytes of each region, the most a frame can stream
+static const std::size_t REGION_SIZE = 1 << 18;
+
+StreamingBuffer::StreamingBuffer() : fences(NB_REGIONS, nullptr) {
+    glGenBuffers(1, &staging);
+    glBindBuffer(GL_COPY_READ_BUFFER, staging);
+    glBufferData(GL_COPY_READ_BUFFER, NB_REGIONS * REGION_SIZE, nullptr,
+                 GL_STREAM_DRAW);
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    for (void* fence : fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+        }
+    }
+    glDeleteBuffers(1, &staging);
+}
+
+/// @brief Copy `size` bytes of `data` at `offset` in `buffer` after the
+/// commands already issued, unless the current region is full.
+/// @param buffer name of the destination buffer
+/// @return whether the update was queued, the caller uploading it another
+/// way otherwise
+bool StreamingBuffer::write(const unsigned buffer, const std::size_t offset,
+                            const void* data, const std::size_t size) {
+    if (used + size > REGION_SIZE) {
+        return false;
+    }
+    if (used == 0) {
+        waitForRegion();
+    }
+    const std::size_t stagingOffset = region * REGION_SIZE + used;
+    glBindBuffer(GL_COPY_READ_BUFFER, staging);
+    // the GPU is done with this region: no need to synchronize
+    void* mapped = glMapBufferRange(
+        GL_COPY_READ_BUFFER, stagingOffset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!mapped) {
+        return false;
+    }
+    std::memcpy(mapped, data, size);
+    if (glUnmapBuffer(GL_COPY_READ_BUFFER) != GL_TRUE) {
+        return false;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                        stagingOffset, offset, size);
+    used += size;
+    streamedBytes += size;
+    return true;
+}
+
+/// @brief Fence the current region after the commands of the frame, and
+/// move to the next one.
+void StreamingBuffer::endFrame() {
+    if (used == 0) {
+        return;
+    }
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % NB_REGIONS;
+    used = 0;
+}
+
+/// @brief Bytes copied through the staging buffer so far.
+std::size_t StreamingBuffer::getStreamedBytes() const { return streamedBytes; }
+
+/// @brief Wait until the GPU has read the previous content of the current
+/// region.
+void StreamingBuffer::waitForRegion() {
+    if (!fences[region]) {
+        return;
+    }
+    GLsync fence = static_cast<GLsync>(fences[region]);
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                            1000000000) == GL_TIMEOUT_EXPIRED) {
+    }
+    glDeleteSync(fence);
+    fences[region] = nullptr;
+}
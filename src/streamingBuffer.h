@@ -0,0 +1,47 @@
+#ifndef STREAMING_BUFFER_H
+#define STREAMING_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+/// @brief Copies small updates into OpenGL buffers without stalling on the
+/// frames still reading them. Non-copyable.
+/// Must be created, used and destroyed on the thread owning the OpenGL
+/// context.
+///
+/// Updates are written into a staging buffer mapped without
+/// synchronization, then copied into their destination on the GPU, in the
+/// order of the draw calls. The staging buffer is a ring of `NB_REGIONS`
+/// regions: the updates of a frame go into the current region, which is
+/// fenced by `endFrame`, and a region is only reused once the GPU has passed
+/// its fence, that is `NB_REGIONS` frames later in practice.
+class StreamingBuffer {
+    unsigned staging{};
+    // fence of each region, nullptr if the region wasn't used since it was
+    // last waited for
+    std::vector<void*> fences{};
+    int region{};
+    // bytes written into the current region
+    std::size_t used{};
+    // bytes written since the creation of the buffer
+    std::size_t streamedBytes{};
+
+    void waitForRegion();
+
+  public:
+    StreamingBuffer();
+    ~StreamingBuffer();
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+    bool write(const unsigned buffer, const std::size_t offset,
+               const void* data, const std::size_t size);
+    void endFrame();
+    std::size_t getStreamedBytes() const;
+};
+
+static_assert(!std::is_copy_constructible<StreamingBuffer>::value,
+              "StreamingBuffer shouldn't be copy constructible.");
+static_assert(!std::is_copy_assignable<StreamingBuffer>::value,
+              "StreamingBuffer shouldn't be copy assignable.");
+
+#endif /* STREAMING_BUFFER_H */
@@ -0,0 +1,247 @@
+#include "substitutionTiling.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+// edge length of the generated prototiles
+static const double TILE_SIZE = 0.2;
+static const int MAX_DEPTH = 30;
+// cells near the region may complete prototiles inside it
+static const double MARGIN = 2.0 * TILE_SIZE;
+
+static const double INV_PHI = (std::sqrt(5.0) - 1.0) / 2.0;
+static const double SQRT2 = std::sqrt(2.0);
+// Ammann-Beenker inflation factor, the silver ratio
+static const double DELTA = 1.0 + SQRT2;
+
+/// @brief Node of the substitution: the triangle (origin, origin + u,
+/// origin + v), half of a prototile of its type and isosceles at `origin`,
+/// or a whole narrow rhomb with an acute angle at `origin`.
+/// Children are given by their vertices in the basis (u, v) of their parent.
+struct Cell {
+    PrototileType type{};
+    dvec2 origin{};
+    dvec2 u{};
+    dvec2 v{};
+    Cell(PrototileType type, const dvec2& origin, const dvec2& u,
+         const dvec2& v)
+        : type(type), origin(origin), u(u), v(v) {};
+};
+
+static std::vector<Cell> scaled(std::vector<Cell> children,
+                                 const double factor) {
+    for (auto& child : children) {
+        child.origin *= factor;
+        child.u *= factor;
+        child.v *= factor;
+    }
+    return children;
+}
+
+// Robinson triangles, with the apex at the origin
+static const std::vector<Cell> THIN_CHILDREN = {
+    {thinRhomb, dvec2(0.0, 1.0), dvec2(INV_PHI, 0.0), dvec2(1.0, 0.0)},
+    {thickRhomb, dvec2(INV_PHI, 0.0), dvec2(0.0, 1.0), dvec2(0.0, 0.0)}};
+static const std::vector<Cell> THICK_CHILDREN = {
+    {thickRhomb, dvec2(1.0 - INV_PHI, INV_PHI), dvec2(0.0, 1.0),
+     dvec2(0.0, 0.0)},
+    {thickRhomb, dvec2(1.0 - INV_PHI, 0.0), dvec2(1.0 - INV_PHI, INV_PHI),
+     dvec2(1.0, 0.0)},
+    {thinRhomb, dvec2(1.0 - INV_PHI, INV_PHI), dvec2(1.0 - INV_PHI, 0.0),
+     dvec2(0.0, 0.0)}};
+
+// right isosceles triangles, with the right angle at the origin
+static const double HALF = SQRT2 / 2.0;
+static const std::vector<Cell> SQUARE_CHILDREN = scaled(
+    {{square, dvec2(1.0 + HALF, HALF), dvec2(1.0, 0.0), dvec2(DELTA, 0.0)},
+     {square, dvec2(HALF, 1.0 + HALF), dvec2(0.0, 1.0), dvec2(0.0, DELTA)},
+     {square, dvec2(HALF, HALF), dvec2(1.0 + HALF, HALF),
+      dvec2(HALF, 1.0 + HALF)},
+     {narrowRhomb, dvec2(0.0, 0.0), dvec2(1.0, 0.0), dvec2(HALF, HALF)},
+     {narrowRhomb, dvec2(0.0, 0.0), dvec2(0.0, 1.0), dvec2(HALF, HALF)}},
+    1.0 / DELTA);
+static const std::vector<Cell> NARROW_CHILDREN = scaled(
+    {{square, dvec2(0.0, 1.0), dvec2(0.0, 0.0), dvec2(SQRT2, 0.0)},
+     {square, dvec2(1.0, 1.0), dvec2(0.0, 1.0), dvec2(0.0, DELTA)},
+     {square, dvec2(DELTA, SQRT2), dvec2(DELTA, DELTA), dvec2(1.0, DELTA)},
+     {square, dvec2(SQRT2, SQRT2), dvec2(DELTA, 0.0), dvec2(DELTA, SQRT2)},
+     {narrowRhomb, dvec2(0.0, 1.0), dvec2(1.0, 1.0), dvec2(SQRT2, 0.0)},
+     {narrowRhomb, dvec2(DELTA, 0.0), dvec2(SQRT2, SQRT2), dvec2(1.0, 1.0)},
+     {narrowRhomb, dvec2(0.0, DELTA), dvec2(1.0, DELTA),
+      dvec2(SQRT2, SQRT2)}},
+    1.0 / DELTA);
+
+static const std::vector<Cell>& getChildren(const PrototileType type) {
+    switch (type) {
+        case thinRhomb:
+            return THIN_CHILDREN;
+        case thickRhomb:
+            return THICK_CHILDREN;
+        case square:
+            return SQUARE_CHILDREN;
+        default:
+            return NARROW_CHILDREN;
+    }
+}
+
+/// @brief Wheel of ten thin halves for Penrose, star of eight narrow rhombs
+/// for Ammann-Beenker, every other one mirrored so that neighbors match.
+static std::vector<Cell> seed(const Substitution substitution,
+                              const int depth) {
+    const bool penrose = substitution == Substitution::penrose;
+    const int count = penrose ? 10 : 8;
+    const double radius =
+        TILE_SIZE * std::pow(penrose ? 1.0 / INV_PHI : DELTA, depth);
+    const double angle = two_pi<double>() / count;
+    // the wheel is symmetric about the x axis
+    const double offset = penrose ? -angle / 2.0 : 0.0;
+    std::vector<Cell> cells{};
+    for (int n = 0; n < count; n++) {
+        dvec2 a = radius * dvec2(std::cos(offset + n * angle),
+                                 std::sin(offset + n * angle));
+        dvec2 b = radius * dvec2(std::cos(offset + (n + 1) * angle),
+                                 std::sin(offset + (n + 1) * angle));
+        if (n % 2) {
+            std::swap(a, b);
+        }
+        cells.emplace_back(penrose ? thinRhomb : narrowRhomb, dvec2(0.0), a,
+                           b);
+    }
+    return cells;
+}
+
+static bool intersects(const Cell& cell, const dvec2& min, const dvec2& max) {
+    dvec2 cellMin =
+        glm::min(cell.origin, cell.origin + glm::min(cell.u, cell.v));
+    dvec2 cellMax =
+        glm::max(cell.origin, cell.origin + glm::max(cell.u, cell.v));
+    if (cell.type == narrowRhomb) {
+        cellMin = glm::min(cellMin, cell.origin + cell.u + cell.v);
+        cellMax = glm::max(cellMax, cell.origin + cell.u + cell.v);
+    }
+    return cellMin.x <= max.x && cellMin.y <= max.y && cellMax.x >= min.x &&
+           cellMax.y >= min.y;
+}
+
+/// @brief Append the children of `cell` which intersect the box to `cells`.
+static void subdivide(const Cell& cell, const dvec2& min, const dvec2& max,
+                      std::vector<Cell>& cells) {
+    for (auto& child : getChildren(cell.type)) {
+        dvec2 origin = cell.origin + child.origin.x * cell.u +
+                       child.origin.y * cell.v;
+        dvec2 u = cell.origin + child.u.x * cell.u + child.u.y * cell.v;
+        dvec2 v = cell.origin + child.v.x * cell.u + child.v.y * cell.v;
+        Cell next(child.type, origin, u - origin, v - origin);
+        if (intersects(next, min, max)) {
+            cells.push_back(next);
+        }
+    }
+}
+
+/// @brief Append the prototile of a final cell to `tiles`. Both halves of a
+/// prototile are cells, only one of them adds it.
+static void emit(const Cell& cell, std::vector<Prototile>& tiles) {
+    switch (cell.type) {
+        case thinRhomb:
+        case thickRhomb:
+            // mirrored halves have opposite orientations
+            if (cell.u.x * cell.v.y - cell.u.y * cell.v.x < 0.0) {
+                return;
+            }
+            break;
+        case square:
+            // halves face opposite directions from their hypotenuse, never
+            // perpendicular to this one
+            if (dot(cell.u + cell.v, dvec2(0.92388, 0.38268)) > 0.0) {
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    tiles.emplace_back(cell.type, cell.origin, vec2(cell.u), vec2(cell.v));
+}
+
+static void expand(const Cell& cell, const int depth, const dvec2& min,
+                   const dvec2& max, std::vector<Prototile>& tiles) {
+    if (depth == 0) {
+        emit(cell, tiles);
+        return;
+    }
+    std::vector<Cell> children{};
+    subdivide(cell, min, max, children);
+    for (auto& child : children) {
+        expand(child, depth - 1, min, max, tiles);
+    }
+}
+
+void SubstitutionTiling::setSubstitution(const Substitution substitution) {
+    if (substitution != this->substitution) {
+        this->substitution = substitution;
+        generated = false;
+    }
+}
+
+Substitution SubstitutionTiling::getSubstitution() const {
+    return substitution;
+}
+
+/// @brief Set the number of inflations, between 1 and `MAX_DEPTH`.
+void SubstitutionTiling::setDepth(const int depth) {
+    int clamped = std::max(1, std::min(depth, MAX_DEPTH));
+    if (clamped != this->depth) {
+        this->depth = clamped;
+        generated = false;
+    }
+}
+
+int SubstitutionTiling::getDepth() const { return depth; }
+
+/// @brief Whether the last generated region contains the box, with the
+/// current substitution and depth.
+bool SubstitutionTiling::covers(const dvec2& min, const dvec2& max) const {
+    return generated && min.x >= this->min.x && min.y >= this->min.y &&
+           max.x <= this->max.x && max.y <= this->max.y;
+}
+
+/// @brief Replace the tiles by the prototiles of the patch intersecting the
+/// box, in depth-first order so that consecutive tiles are close.
+/// @param min
+/// @param max
+/// @param pool expands subtrees in parallel
+void SubstitutionTiling::generate(const dvec2& min, const dvec2& max,
+                                  ThreadPool& pool) {
+    const dvec2 low = min - dvec2(MARGIN);
+    const dvec2 high = max + dvec2(MARGIN);
+    std::vector<Cell> cells = seed(substitution, depth);
+    int remaining = depth;
+    // split breadth first until each worker gets a few subtrees
+    while (remaining > 0 &&
+           static_cast<int>(cells.size()) < 4 * pool.size()) {
+        std::vector<Cell> next{};
+        for (auto& cell : cells) {
+            subdivide(cell, low, high, next);
+        }
+        cells.swap(next);
+        remaining--;
+    }
+    std::vector<std::vector<Prototile>> parts(cells.size());
+    pool.parallelFor(0, cells.size(), [&](int begin, int end) {
+        for (int n = begin; n < end; n++) {
+            expand(cells[n], remaining, low, high, parts[n]);
+        }
+    });
+    tiles.clear();
+    for (auto& part : parts) {
+        tiles.insert(tiles.end(), part.begin(), part.end());
+    }
+    this->min = min;
+    this->max = max;
+    generated = true;
+}
+
+const std::vector<Prototile>& SubstitutionTiling::getTiles() const {
+    return tiles;
+}
@@ -0,0 +1,60 @@
+#ifndef SUBSTITUTION_TILING_H
+#define SUBSTITUTION_TILING_H
+
+#include "threadPool.h"
+#include <glm/vec2.hpp>
+#include <vector>
+
+enum class Substitution { penrose, ammannBeenker };
+
+enum PrototileType {
+    // Penrose rhombs, with an angle of 36 and 72 degrees
+    thinRhomb,
+    thickRhomb,
+    // Ammann-Beenker square and rhomb with an angle of 45 degrees
+    square,
+    narrowRhomb
+};
+
+/// @brief Parallelogram spanned by `u` and `v` from `origin`: the image of
+/// the unit square by the model matrix (u, v, origin). The origin is in
+/// double precision like the positions of polygons.
+struct Prototile {
+    PrototileType type{};
+    glm::dvec2 origin{};
+    glm::vec2 u{};
+    glm::vec2 v{};
+    Prototile(PrototileType type, const glm::dvec2& origin, const glm::vec2& u,
+              const glm::vec2& v)
+        : type(type), origin(origin), u(u), v(v) {};
+};
+
+/// @brief Aperiodic patch generated by inflating a seed `depth` times, with
+/// edges of the final prototiles of length `TILE_SIZE`.
+///
+/// Penrose rhombs are made of Robinson triangles and Ammann-Beenker squares
+/// of right isosceles triangles: the substitution runs on these halves,
+/// whose children stay inside their parent. Subtrees outside the requested
+/// region are skipped, so a deep patch costs about as much as its visible
+/// part, and the remaining subtrees are expanded in parallel.
+class SubstitutionTiling {
+    Substitution substitution = Substitution::penrose;
+    int depth = 10;
+    std::vector<Prototile> tiles{};
+    // region covered by `tiles`
+    glm::dvec2 min{};
+    glm::dvec2 max{};
+    bool generated = false;
+
+  public:
+    void setSubstitution(const Substitution substitution);
+    Substitution getSubstitution() const;
+    void setDepth(const int depth);
+    int getDepth() const;
+    bool covers(const glm::dvec2& min, const glm::dvec2& max) const;
+    void generate(const glm::dvec2& min, const glm::dvec2& max,
+                  ThreadPool& pool);
+    const std::vector<Prototile>& getTiles() const;
+};
+
+#endif /* SUBSTITUTION_TILING_H */
@@ -0,0 +1,150 @@
+#include "svgWriter.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstring>
+
+// bytes gathered before writing to the file
+static const std::size_t BUFFER_CAPACITY = 1 << 16;
+// width of the outlines and of the segments, in plane units (polygon sides
+// are 0.2 long)
+static const double OUTLINE_WIDTH = 0.004;
+static const double SEGMENT_WIDTH = 0.012;
+
+/// @brief Create `filename` and write the header of a drawing of the box
+/// from `min` to `max`.
+SvgWriter::SvgWriter(const std::string& filename, const glm::dvec2& min,
+                     const glm::dvec2& max)
+    : file(filename, std::ios::binary), min(min) {
+    if (!file) {
+        logError("Failed to create the SVG file.");
+        return;
+    }
+    valid = true;
+    buffer.reserve(BUFFER_CAPACITY);
+    const glm::dvec2 size = max - min;
+    char header[256] = {};
+    std::snprintf(header, sizeof(header),
+                  "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+                  "viewBox=\"0 %.6g %.6g %.6g\">\n"
+                  "<g transform=\"scale(1,-1)\" stroke=\"#000\" "
+                  "stroke-linejoin=\"round\" stroke-linecap=\"round\">\n",
+                  -size.y, size.x, size.y);
+    write(header);
+}
+
+SvgWriter::~SvgWriter() {
+    if (valid) {
+        logError("SVG file left incomplete.");
+    }
+}
+
+bool SvgWriter::isValid() const { return valid; }
+
+/// @brief Append a polygon filled with `color` and outlined in black.
+/// @param points vertices in order
+/// @param count number of vertices
+/// @param color RGB components between 0 and 1
+void SvgWriter::addPolygon(const glm::dvec2* points, const int count,
+                           const glm::vec3& color) {
+    if (!valid || count == 0) {
+        return;
+    }
+    openGroup(Group::polygons);
+    char fill[32] = {};
+    std::snprintf(fill, sizeof(fill), "<path fill=\"#%02x%02x%02x\" d=\"M",
+                  static_cast<int>(255.0f * color.x + 0.5f),
+                  static_cast<int>(255.0f * color.y + 0.5f),
+                  static_cast<int>(255.0f * color.z + 0.5f));
+    write(fill);
+    writePoint(points[0]);
+    write("L");
+    for (int n = 1; n < count; n++) {
+        writePoint(points[n]);
+    }
+    write("Z\"/>\n");
+}
+
+/// @brief Append a thick black segment from `a` to `b`.
+void SvgWriter::addSegment(const glm::dvec2& a, const glm::dvec2& b) {
+    if (!valid) {
+        return;
+    }
+    openGroup(Group::segments);
+    write("<path d=\"M");
+    writePoint(a);
+    write("L");
+    writePoint(b);
+    write("\"/>\n");
+}
+
+/// @brief Write the end of the document.
+/// @return whether the whole document was written successfully
+bool SvgWriter::close() {
+    if (!valid) {
+        return false;
+    }
+    openGroup(Group::none);
+    write("</g>\n</svg>\n");
+    flush();
+    valid = false;
+    file.close();
+    return static_cast<bool>(file);
+}
+
+void SvgWriter::write(const char* text) { write(text, std::strlen(text)); }
+
+void SvgWriter::write(const char* text, const std::size_t size) {
+    if (buffer.size() + size > BUFFER_CAPACITY) {
+        flush();
+    }
+    buffer.insert(buffer.end(), text, text + size);
+}
+
+/// @brief Write `value` with 5 decimals (a 50000th of a polygon side),
+/// without trailing zeros.
+void SvgWriter::writeNumber(const double value) {
+    char number[32] = {};
+    int size = std::snprintf(number, sizeof(number), "%.5f", value);
+    while (size > 1 && number[size - 1] == '0') {
+        size--;
+    }
+    if (number[size - 1] == '.') {
+        size--;
+    }
+    write(number, size);
+}
+
+/// @brief Write " x y" relative to `min`, in the flipped frame of the
+/// drawing.
+void SvgWriter::writePoint(const glm::dvec2& point) {
+    write(" ");
+    writeNumber(point.x - min.x);
+    write(" ");
+    writeNumber(point.y - min.y);
+}
+
+void SvgWriter::flush() {
+    file.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+/// @brief Close the current group and open `group` if it is another one.
+void SvgWriter::openGroup(const Group group) {
+    if (group == this->group) {
+        return;
+    }
+    if (this->group != Group::none) {
+        write("</g>\n");
+    }
+    this->group = group;
+    char start[64] = {};
+    if (group == Group::polygons) {
+        std::snprintf(start, sizeof(start), "<g stroke-width=\"%g\">\n",
+                      OUTLINE_WIDTH);
+    } else if (group == Group::segments) {
+        std::snprintf(start, sizeof(start),
+                      "<g fill=\"none\" stroke-width=\"%g\">\n",
+                      SEGMENT_WIDTH);
+    }
+    write(start);
+}
@@ -0,0 +1,48 @@
+#ifndef SVG_WRITER_H
+#define SVG_WRITER_H
+
+#include <cstddef>
+#include <fstream>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <string>
+#include <vector>
+
+/// @brief Writes filled polygons and segments to an SVG file as they come,
+/// without building the document in memory. Non-copyable.
+///
+/// The drawing shows the box from `min` to `max` of the plane, y pointing
+/// up. Coordinates are written relative to `min`, so that they keep their
+/// precision far from the origin, into a buffer flushed to the file
+/// whenever it is full.
+class SvgWriter {
+    std::ofstream file{};
+    std::vector<char> buffer{};
+    glm::dvec2 min{};
+    // polygons share the width of their outline, segments their width and
+    // the absence of fill
+    enum class Group { none, polygons, segments };
+    Group group = Group::none;
+    bool valid = false;
+
+    void write(const char* text);
+    void write(const char* text, const std::size_t size);
+    void writeNumber(const double value);
+    void writePoint(const glm::dvec2& point);
+    void flush();
+    void openGroup(const Group group);
+
+  public:
+    SvgWriter(const std::string& filename, const glm::dvec2& min,
+              const glm::dvec2& max);
+    ~SvgWriter();
+    SvgWriter(const SvgWriter&) = delete;
+    SvgWriter& operator=(const SvgWriter&) = delete;
+    bool isValid() const;
+    void addPolygon(const glm::dvec2* points, const int count,
+                    const glm::vec3& color);
+    void addSegment(const glm::dvec2& a, const glm::dvec2& b);
+    bool close();
+};
+
+#endif /* SVG_WRITER_H */
@@ -0,0 +1,96 @@
+#include "threadPool.h"
+#include <algorithm>
+#include <exception>
+
+/// @brief Start `nbThreads` workers (at least one).
+/// @param nbThreads defaults to the number of hardware threads
+ThreadPool::ThreadPool(int nbThreads) {
+    nbThreads = std::max(nbThreads, 1);
+    for (int n = 0; n < nbThreads; n++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+/// @brief Finish the queued tasks and join the workers.
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const { return workers.size(); }
+
+void ThreadPool::submit(const std::function<void()>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(task);
+    }
+    taskAvailable.notify_one();
+}
+
+/// @brief Call `function(chunkBegin, chunkEnd)` on contiguous chunks covering
+/// `begin` to `end` excluded, and wait until all chunks are done.
+/// @param begin
+/// @param end
+/// @param function should only write to data indexed in its chunk
+/// @throw the first exception thrown by `function`, once all chunks are done
+/// @note Must not be called from a task of this pool.
+void ThreadPool::parallelFor(const int begin, const int end,
+                             const std::function<void(int, int)>& function) {
+    if (end <= begin) {
+        return;
+    }
+    // a few chunks per worker balance uneven chunks
+    const int maxChunks = std::min(end - begin, 4 * size());
+    const int chunkSize = (end - begin + maxChunks - 1) / maxChunks;
+    int remaining = (end - begin + chunkSize - 1) / chunkSize;
+    std::mutex doneMutex{};
+    std::condition_variable done{};
+    std::exception_ptr error{};
+    for (int chunk = begin; chunk < end; chunk += chunkSize) {
+        int chunkEnd = std::min(chunk + chunkSize, end);
+        submit([&, chunk, chunkEnd]() {
+            std::exception_ptr chunkError{};
+            try {
+                function(chunk, chunkEnd);
+            } catch (...) {
+                chunkError = std::current_exception();
+            }
+            // the chunk counts as done even if it failed
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (chunkError && !error) {
+                error = chunkError;
+            }
+            if (--remaining == 0) {
+                done.notify_one();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&remaining]() { return remaining == 0; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task{};
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock,
+                               [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// @brief Fixed set of worker threads running queued tasks. Non-copyable.
+///
+/// `parallelFor` splits a range of polygon ids into contiguous chunks, so
+/// passes writing only to the ids of their chunk give the same results
+/// whatever the number of threads.
+class ThreadPool {
+    std::vector<std::thread> workers{};
+    std::queue<std::function<void()>> tasks{};
+    std::mutex mutex{};
+    std::condition_variable taskAvailable{};
+    bool stopping = false;
+
+    void work();
+
+  public:
+    ThreadPool(int nbThreads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    int size() const;
+    void submit(const std::function<void()>& task);
+    void parallelFor(const int begin, const int end,
+                     const std::function<void(int, int)>& function);
+};
+
+#endif /* THREAD_POOL_H */
@@ -0,0 +1,847 @@
+#include "tiling.h"
+#include "dualGraph.h"
+#include "edge.h"
+#include "graphColoring.h"
+#include "svgWriter.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <iostream>
+
+using namespace glm;
+
+// revisions kept in `Tiling::changes`, enough for the renderer to follow a
+// few frames behind the edits
+static const std::size_t MAX_CHANGES = 64;
+
+/// @brief Whether convex polygons `a` and `b` overlap by more than
+/// `DISTANCE_THRESHOLD`, using the separating axis theorem.
+static bool convexPolygonsOverlap(const std::vector<dvec2>& a,
+                                  const std::vector<dvec2>& b) {
+    for (const std::vector<dvec2>* polygon : {&a, &b}) {
+        const std::vector<dvec2>& points = *polygon;
+        for (std::size_t n = 0; n < points.size(); n++) {
+            dvec2 side = points[(n + 1) % points.size()] - points[n];
+            dvec2 axis = normalize(dvec2(-side.y, side.x));
+            double minA = INFINITY, maxA = -INFINITY;
+            double minB = INFINITY, maxB = -INFINITY;
+            for (auto& point : a) {
+                minA = std::min(minA, dot(point, axis));
+                maxA = std::max(maxA, dot(point, axis));
+            }
+            for (auto& point : b) {
+                minB = std::min(minB, dot(point, axis));
+                maxB = std::max(maxB, dot(point, axis));
+            }
+            if (std::min(maxA, maxB) - std::max(minA, minB) <
+                DISTANCE_THRESHOLD) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Whether `a` and `b` are the same vertex.
+static bool isNear(const dvec2& a, const dvec2& b) {
+    return distance(a, b) < DISTANCE_THRESHOLD;
+}
+
+Tiling::Tiling() { currentEdge = edges.cbegin(); }
+
+/// @brief Create a Polygon with `nbSides` on the position of `currentEdge`.
+/// The new polygon sides are stored in `edges` or `links`.
+///
+/// The polygon is first added to `geometry`, whose vertices are compared.
+/// Then all new edges are stored in `edges`, and overlapping edges
+/// contiguous in `edges` are detected and moved to `links`. Non-contiguous
+/// overlapping edges aren't detected and remain stored in `edges`.
+///
+/// The polygon is then added to `graph` and `vertices`, and given a color
+/// unused by the polygons it shares a side with.
+/// @param nbSides
+void Tiling::addPolygon(int nbSides) {
+    if (polygons.empty()) {
+        polygons.emplace_back(new Polygon(nbSides));
+        polygons.back()->setId(0);
+        geometry.addPolygon(*polygons.back());
+        for (int i = 0; i < nbSides; i++) {
+            insertEdge(edges.cend(), Edge(polygons.back(), i));
+        }
+        currentEdge = edges.cbegin();
+    } else {
+        // create new polygon
+        polygons.emplace_back(new Polygon(nbSides));
+        polygons.back()->bindTo(currentEdge->polygon, currentEdge->edge);
+        polygons.back()->setId(polygons.size() - 1);
+        geometry.addPolygon(*polygons.back());
+        // store the new edges in `edges` (between iterators `left` and `right`)
+        auto right = circularNext(currentEdge);
+        std::list<Edge>::const_iterator left = right;
+        for (int i = nbSides - 1; i >= 0; i--) {
+            left = insertEdge(left, Edge(polygons.back(), i));
+        }
+        // for any consecutive overlapping edges
+        // (1) update `links` (insert the two overlapping edges)
+        // (2) update `edges` (remove the two overlapping edges)
+        // /!\ pay attention not to invalidate `left`
+        while (right->connectedTo(*circularPrev(right), geometry)) {
+            // cf (1)
+            links.emplace(*right, *circularPrev(right));
+            links.emplace(*circularPrev(right), *right);
+            // cf /!\ .
+            if (circularPrev(right) == left) {
+                left = circularNext(right);
+                // cf (2)
+                eraseEdge(circularPrev(right));
+                right = circularNext(right);
+                eraseEdge(circularPrev(right));
+                break;
+            }
+            // cf (2)
+            eraseEdge(circularPrev(right));
+            right = circularNext(right);
+            eraseEdge(circularPrev(right));
+        }
+        while (left->connectedTo(*circularPrev(left), geometry)) {
+            // cf (1)
+            links.emplace(*left, *circularPrev(left));
+            links.emplace(*circularPrev(left), *left);
+            // cf (2)
+            eraseEdge(circularPrev(left));
+            left = circularNext(left);
+            eraseEdge(circularPrev(left));
+        }
+        currentEdge = left;
+    }
+    auto& polygon = polygons.back();
+    graph.addPolygon(*polygon, geometry);
+    const int firstColored = colorPolygon(graph, polygons, polygon->getId());
+    vertices.addPolygon(*polygon);
+    recordChange(firstColored);
+}
+
+/// @brief Whether a Polygon with `nbSides` on the position of `currentEdge`
+/// would overlap no polygon, see `overlapsPolygons`.
+bool Tiling::canAddPolygon(const int nbSides) const {
+    if (polygons.empty()) {
+        return true;
+    }
+    Polygon polygon(nbSides, false);
+    polygon.bindTo(currentEdge->polygon, currentEdge->edge);
+    return !overlapsPolygons(polygon);
+}
+
+/// @brief Create a Polygon with `nbSides` on every edge of `edges` satisfying
+/// `predicate`.
+///
+/// Edges are selected on the current tiling, then each polygon is kept only
+/// if it doesn't overlap the tiling or the polygons kept before it. The
+/// sides of the kept polygons are inserted after their edge in `edges`, and
+/// overlapping edges are moved to `links` in a single pass. The polygons are
+/// then added to `graph` and `vertices` and colored, like in `addPolygon`.
+/// @param nbSides
+/// @param predicate selects the edges, evaluated before any change
+/// @return number of polygons created
+int Tiling::addPolygons(int nbSides,
+                        const std::function<bool(const Edge&)>& predicate) {
+    if (edges.empty()) {
+        return 0;
+    }
+    std::vector<std::list<Edge>::const_iterator> selected{};
+    for (auto edge = edges.cbegin(); edge != edges.cend(); edge++) {
+        if (predicate(*edge)) {
+            selected.push_back(edge);
+        }
+    }
+
+    // keep polygons overlapping nothing, `geometry` indexes the kept ones
+    const int firstId = polygons.size();
+    for (auto edge : selected) {
+        // candidates don't log, there may be thousands of them
+        std::shared_ptr<Polygon> polygon(new Polygon(nbSides, false));
+        polygon->bindTo(edge->polygon, edge->edge);
+        if (overlapsPolygons(*polygon)) {
+            continue;
+        }
+        polygon->setId(polygons.size());
+        polygons.push_back(polygon);
+        geometry.addPolygon(*polygon);
+        // sides inserted after `edge`, in the same order as `addPolygon`
+        auto right = std::next(edge);
+        for (int i = nbSides - 1; i >= 0; i--) {
+            right = insertEdge(right, Edge(polygon, i));
+        }
+    }
+
+    const Edge cursor = *currentEdge;
+    linkEdges(firstId);
+    auto position = edgePositions.find(cursor);
+    currentEdge =
+        position != edgePositions.end() ? position->second : edges.cbegin();
+
+    int firstChanged = firstId;
+    for (std::size_t id = firstId; id < polygons.size(); id++) {
+        graph.addPolygon(*polygons[id], geometry);
+        firstChanged =
+            std::min(firstChanged, colorPolygon(graph, polygons, id));
+        vertices.addPolygon(*polygons[id]);
+    }
+    int count = polygons.size() - firstId;
+    recordChange(firstChanged);
+    std::clog << "Placed " << count << " polygons out of " << selected.size()
+              << " selected edges." << std::endl;
+    return count;
+}
+
+/// @brief Whether `polygon` overlaps a polygon of `geometry`. Sharing sides
+/// or vertices isn't overlapping.
+bool Tiling::overlapsPolygons(const Polygon& polygon) const {
+    std::vector<dvec2> points{};
+    for (int n = 0; n < polygon.nbSides; n++) {
+        points.push_back(polygon.getVertex(n));
+    }
+    dvec2 min = points[0], max = points[0];
+    for (auto& point : points) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    std::vector<int> ids{};
+    geometry.findPolygons(min, max, ids);
+    std::vector<dvec2> otherPoints{};
+    for (int id : ids) {
+        otherPoints.clear();
+        for (int n = 0; n < polygons[id]->nbSides; n++) {
+            otherPoints.push_back(geometry.getVertex(id, n));
+        }
+        if (convexPolygonsOverlap(points, otherPoints)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Move consecutive connected edges of `edges` to `links`, like
+/// `addPolygon` does around the new polygon but for the whole list at once.
+///
+/// Edges are pushed on a stack while walking the list, an edge connected to
+/// the top of the stack cancelling it. Only pairs involving a side of a
+/// polygon with id `firstId` or more are tested.
+/// @param firstId
+void Tiling::linkEdges(const int firstId) {
+    auto tryLink = [&](std::list<Edge>::const_iterator a,
+                       std::list<Edge>::const_iterator b) {
+        if ((a->polygon->getId() < firstId &&
+             b->polygon->getId() < firstId) ||
+            !a->connectedTo(*b, geometry)) {
+            return false;
+        }
+        links.emplace(*a, *b);
+        links.emplace(*b, *a);
+        return true;
+    };
+    std::vector<std::list<Edge>::const_iterator> stack{};
+    for (auto edge = edges.cbegin(); edge != edges.cend();) {
+        if (!stack.empty() && tryLink(stack.back(), edge)) {
+            eraseEdge(stack.back());
+            stack.pop_back();
+            edge = eraseEdge(edge);
+        } else {
+            stack.push_back(edge);
+            edge++;
+        }
+    }
+    // `edges` is circular
+    while (edges.size() >= 2 &&
+           tryLink(std::prev(edges.cend()), edges.cbegin())) {
+        eraseEdge(std::prev(edges.cend()));
+        eraseEdge(edges.cbegin());
+    }
+}
+
+/// @brief Recolor all polygons, trying to use as few colors as possible.
+void Tiling::recolorAllPolygons() {
+    int nbColors = recolorPolygons(graph, polygons);
+    recordChange(0);
+    std::clog << "Polygons recolored using " << nbColors << " colors."
+              << std::endl;
+}
+
+/// @brief Whether `removeLastPolygon` can remove the Polygon created last:
+/// the polygons surrounded by others since then can't be removed yet.
+bool Tiling::canRemoveLastPolygon() const {
+    if (polygons.size() <= 1) {
+        return !polygons.empty();
+    }
+    const auto& lastPolygon = polygons.back();
+    return std::any_of(edges.begin(), edges.end(), [&](const Edge& edge) {
+        return edge.polygon == lastPolygon;
+    });
+}
+
+/// @brief Remove the Polygon created last. Variables `edges` and `links` are
+/// updated accordingly.
+///
+/// First, edges overlapping with the most recent polygon are added to `edges`
+/// and removed from `links`. Then the sides from the last polygon are
+/// removed from `edges` and the polygon is removed from `polygons`.
+///
+/// @note This implementation supposes that the edges of the last polygon are
+/// all adjacent in `edges` (there sequential in the _circular_ list, but may
+/// not be sequential in the underlying list).
+///
+/// @note Removing the polygon pointed by `currentEdge` instead of the last
+/// polygon might result in polygons not being linked anymore.
+void Tiling::removeLastPolygon() {
+    if (polygons.empty()) {
+        return;
+    } else if (polygons.size() == 1) {
+        removeAllPolygons();
+        return;
+    }
+    auto lastPolygon = polygons.back();
+    // TODO using a const iterator is not needed so no need to use it
+    std::list<Edge>::const_iterator left =
+        std::find_if(edges.begin(), edges.end(), [lastPolygon](Edge& edge) {
+            return (edge.polygon == lastPolygon);
+        });
+    std::list<Edge>::const_reverse_iterator _right =
+        std::find_if(edges.rbegin(), edges.rend(), [lastPolygon](Edge& edge) {
+            return (edge.polygon == lastPolygon);
+        });
+    if (left == edges.end() || _right == edges.rend()) {
+        // FIXME
+        logError("Removal of a polygon with no accessible sides is not "
+                 "implemented yet.");
+        return;
+    }
+    auto right = std::prev(_right.base());
+    if (left->edge > right->edge) {
+        // Unfortunately lastPolygon edges aren't sequential as they span the
+        // end and begining of the list.
+        auto futureRight =
+            std::find_if(edges.begin(), edges.end(), [lastPolygon](Edge& edge) {
+                return (edge.polygon != lastPolygon);
+            });
+        edges.splice(edges.cend(), edges, edges.cbegin(), futureRight);
+        removeLastPolygon();
+        return;
+    }
+    int rightEdge = right->edge;
+    right = std::next(right);
+    for (int side = rightEdge + 1; side <= lastPolygon->nbSides - 1; side++) {
+        auto edge = Edge{lastPolygon, side};
+        auto linkedEdge = links.at(edge);
+        right = insertEdge(right, linkedEdge);
+        links.erase(edge);
+        links.erase(linkedEdge);
+    }
+    for (int side = left->edge - 1; side >= 0; side--) {
+        auto edge = Edge{lastPolygon, side};
+        auto linkedEdge = links.at(edge);
+        insertEdge(left, linkedEdge);
+        links.erase(edge);
+        links.erase(linkedEdge);
+    }
+    if (currentEdge->polygon == lastPolygon) {
+        currentEdge = circularPrev(left);
+    }
+    while (left != right) {
+        left = eraseEdge(left);
+    }
+    vertices.removePolygon(*lastPolygon);
+    graph.removeLastPolygon(*lastPolygon, geometry);
+    geometry.removeLastPolygon();
+    polygons.pop_back();
+    recordChange(polygons.size());
+}
+
+/// @brief Write the dual graph of the tiling to `filename`.bin (binary) and
+/// `filename`.txt (text).
+/// @param filename without extension
+/// @param pool
+void Tiling::exportDualGraph(const std::string& filename,
+                             ThreadPool& pool) const {
+    DualGraph dual(graph, polygons, pool);
+    std::ofstream binary(filename + ".bin", std::ios::binary);
+    dual.writeBinary(binary);
+    std::ofstream text(filename + ".txt");
+    dual.writeText(text);
+    if (!binary || !text) {
+        logError("Failed to export the dual graph.");
+        return;
+    }
+    std::clog << "Dual graph exported to " << filename << ".bin and "
+              << filename << ".txt" << std::endl;
+}
+
+/// @brief Write the tiling to the text file `filename`, see `TilingWriter`.
+/// Lines are written in the order of the ids and of `edges`, so that
+/// similar tilings give similar files.
+void Tiling::save(const std::string& filename) const {
+    TilingWriter writer(filename);
+    if (!writer.isValid()) {
+        return;
+    }
+    for (auto& polygon : polygons) {
+        writer.writePolygon(polygon->nbSides, polygon->getColorIndex(),
+                            polygon->getVertex(0), polygon->getVertex(1));
+    }
+    for (auto& edge : edges) {
+        writer.writeEdge(edge.polygon->getId(), edge.edge);
+    }
+    for (auto& polygon : polygons) {
+        for (int side = 0; side < polygon->nbSides; side++) {
+            auto link = links.find(Edge(polygon, side));
+            // each pair once, from its lower id and side
+            if (link == links.end() ||
+                std::make_pair(link->second.polygon->getId(),
+                               link->second.edge) <
+                    std::make_pair(polygon->getId(), side)) {
+                continue;
+            }
+            writer.writeLink(polygon->getId(), side,
+                             link->second.polygon->getId(), link->second.edge);
+        }
+    }
+    if (currentEdge != edges.cend()) {
+        writer.writeCursor(currentEdge->polygon->getId(), currentEdge->edge);
+    }
+    if (!writer.close()) {
+        logError("Failed to save the tiling.");
+        return;
+    }
+    std::clog << "Tiling saved to " << filename << std::endl;
+}
+
+/// @brief Apply a record of a tiling file, on a tiling holding the polygons
+/// loaded before it: a polygon is added with its saved color, and added to
+/// `geometry`, `graph` and `vertices`; an edge is appended to `edges`.
+/// @return false if the record is invalid (e.g. a polygon with more than
+/// `MAX_NB_SIDES` sides or a position which isn't finite) or refers to a
+/// missing polygon or side, in which case it is ignored
+bool Tiling::load(const TilingRecord& record) {
+    const int nbPolygons = polygons.size();
+    auto isSide = [&](const int polygon, const int side) {
+        return polygon >= 0 && polygon < nbPolygons && side >= 0 &&
+               side < polygons[polygon]->nbSides;
+    };
+    switch (record.type) {
+        case TilingRecordType::polygon: {
+            if (record.nbSides < 3 || record.nbSides > MAX_NB_SIDES ||
+                record.color < 0 || record.color >= NB_COLORS ||
+                !std::isfinite(record.a.x) || !std::isfinite(record.a.y) ||
+                !std::isfinite(record.b.x) || !std::isfinite(record.b.y)) {
+                logError("Invalid polygon in the tiling file.");
+                return false;
+            }
+            // loaded polygons don't log, there may be millions of them
+            polygons.emplace_back(
+                new Polygon(record.nbSides, false, record.a, record.b));
+            auto& polygon = polygons.back();
+            polygon->setColor(static_cast<PolygonColor>(record.color));
+            polygon->setId(nbPolygons);
+            geometry.addPolygon(*polygon);
+            graph.addPolygon(*polygon, geometry);
+            vertices.addPolygon(*polygon);
+            recordChange(nbPolygons);
+            return true;
+        }
+        case TilingRecordType::edge: {
+            if (!isSide(record.polygon, record.side) ||
+                edgePositions.count(
+                    Edge(polygons[record.polygon], record.side))) {
+                break;
+            }
+            insertEdge(edges.cend(),
+                       Edge(polygons[record.polygon], record.side));
+            if (currentEdge == edges.cend()) {
+                currentEdge = edges.cbegin();
+            }
+            return true;
+        }
+        case TilingRecordType::link: {
+            if (!isSide(record.polygon, record.side) ||
+                !isSide(record.otherPolygon, record.otherSide)) {
+                break;
+            }
+            Edge edge(polygons[record.polygon], record.side);
+            Edge other(polygons[record.otherPolygon], record.otherSide);
+            links.emplace(edge, other);
+            links.emplace(other, edge);
+            return true;
+        }
+        case TilingRecordType::cursor: {
+            if (!isSide(record.polygon, record.side)) {
+                break;
+            }
+            auto position =
+                edgePositions.find(Edge(polygons[record.polygon], record.side));
+            if (position == edgePositions.end()) {
+                break;
+            }
+            currentEdge = position->second;
+            return true;
+        }
+    }
+    logError("The tiling file refers to a missing side.");
+    return false;
+}
+
+/// @brief Write the whole tiling to the SVG file `filename`, see
+/// `exportSvg(filename, min, max)`.
+void Tiling::exportSvg(const std::string& filename) const {
+    glm::dvec2 min(INFINITY), max(-INFINITY);
+    for (int id = 0; id < geometry.size(); id++) {
+        glm::dvec2 polygonMin{}, polygonMax{};
+        geometry.getBounds(id, polygonMin, polygonMax);
+        min = glm::min(min, polygonMin);
+        max = glm::max(max, polygonMax);
+    }
+    if (geometry.size() == 0) {
+        min = max = glm::dvec2(0.0);
+    }
+    exportSvg(filename, min, max);
+}
+
+/// @brief Write the polygons whose bounding box intersects the box from
+/// `min` to `max` to the SVG file `filename`, filled with their color, then
+/// the edges accessible to the cursor as thick segments, like on screen.
+/// The polygons are walked once and streamed to the file.
+void Tiling::exportSvg(const std::string& filename, const glm::dvec2& min,
+                       const glm::dvec2& max) const {
+    SvgWriter svg(filename, min, max);
+    if (!svg.isValid()) {
+        return;
+    }
+    int count = 0;
+    std::vector<glm::dvec2> points{};
+    for (auto& polygon : polygons) {
+        const int id = polygon->getId();
+        if (!geometry.intersects(id, min, max)) {
+            continue;
+        }
+        points.resize(polygon->nbSides);
+        for (int vertex = 0; vertex < polygon->nbSides; vertex++) {
+            points[vertex] = geometry.getVertex(id, vertex);
+        }
+        svg.addPolygon(points.data(), polygon->nbSides,
+                       getColor(static_cast<PolygonColor>(
+                           polygon->getColorIndex())));
+        count++;
+    }
+    for (auto& edge : edges) {
+        const int id = edge.polygon->getId();
+        glm::dvec2 a = geometry.getVertex(id, edge.edge);
+        glm::dvec2 b = geometry.getVertex(id, edge.edge + 1);
+        if (glm::max(a.x, b.x) >= min.x && glm::min(a.x, b.x) <= max.x &&
+            glm::max(a.y, b.y) >= min.y && glm::min(a.y, b.y) <= max.y) {
+            svg.addSegment(a, b);
+        }
+    }
+    if (!svg.close()) {
+        logError("Failed to export the SVG file.");
+        return;
+    }
+    std::clog << count << " polygons exported to " << filename << std::endl;
+}
+
+/// @brief Fill the CPU subsystems of `usage`: per polygon, its shared_ptr,
+/// control block, object and points, then one list node and one index node
+/// per accessible edge and two map nodes per pair of linked sides.
+void Tiling::getMemoryUsage(MemoryUsage& usage) const {
+    usage.polygons = vectorBytes(polygons);
+    for (auto& polygon : polygons) {
+        usage.polygons += SHARED_PTR_CONTROL_BYTES + sizeof(Polygon) +
+                          vectorBytes(polygon->getPoints());
+    }
+    usage.boundary = listBytes(edges) + unorderedMapBytes(edgePositions);
+    usage.links = unorderedMapBytes(links);
+    usage.geometry = geometry.getMemoryUsage();
+    usage.graph = graph.getMemoryUsage();
+    usage.vertices = vertices.getMemoryUsage();
+}
+
+void Tiling::debug() const {
+    /* for (auto& polygon : polygons) {
+        polygon->debug();
+    } */
+    for (auto& edge : edges) {
+        std::clog << edge.polygon.get() << " " << edge.edge << std::endl;
+    }
+    std::clog << std::endl;
+}
+/// @brief Check that `edges` and `links` describe the polygons consistently:
+/// - every polygon side is either in `edges` once, with its position in
+///   `edgePositions`, or in `links`
+/// - every link is symmetric, between two sides with the same vertices in
+///   reverse order
+/// - `edges` is a closed loop: each edge ends where the next one starts
+/// Linear in the number of sides. Shared sides missing from `links` are
+/// counted by `countOverlappingEdges` instead, see the note of Tiling.
+/// @param error set to the first invariant found broken
+/// @return whether all invariants hold
+bool Tiling::checkInvariants(std::string& error) const {
+    auto name = [](const Edge& edge) {
+        return std::to_string(edge.polygon->getId()) + ":" +
+               std::to_string(edge.edge);
+    };
+    auto start = [this](const Edge& edge) {
+        return geometry.getVertex(edge.polygon->getId(), edge.edge);
+    };
+    auto end = [this](const Edge& edge) {
+        return geometry.getVertex(edge.polygon->getId(), edge.edge + 1);
+    };
+
+    std::size_t nbSides = 0;
+    for (auto& polygon : polygons) {
+        nbSides += polygon->nbSides;
+    }
+    if (edges.size() + links.size() != nbSides ||
+        edgePositions.size() != edges.size()) {
+        error = std::to_string(nbSides) + " sides but " +
+                std::to_string(edges.size()) + " edges, " +
+                std::to_string(edgePositions.size()) + " positions and " +
+                std::to_string(links.size()) + " linked sides.";
+        return false;
+    }
+    for (auto edge = edges.cbegin(); edge != edges.cend(); edge++) {
+        auto position = edgePositions.find(*edge);
+        if (position == edgePositions.end() || position->second != edge) {
+            error = "Edge " + name(*edge) + " has no position.";
+            return false;
+        }
+        if (links.count(*edge)) {
+            error = "Edge " + name(*edge) + " is also linked.";
+            return false;
+        }
+        auto next = std::next(edge) == edges.cend() ? edges.cbegin()
+                                                    : std::next(edge);
+        if (!isNear(end(*edge), start(*next))) {
+            error = "Edges " + name(*edge) + " and " + name(*next) +
+                    " aren't contiguous.";
+            return false;
+        }
+    }
+    for (auto& link : links) {
+        auto back = links.find(link.second);
+        if (back == links.end() || !(back->second == link.first)) {
+            error = "Link from " + name(link.first) + " to " +
+                    name(link.second) + " isn't symmetric.";
+            return false;
+        }
+        if (!isNear(start(link.first), end(link.second)) ||
+            !isNear(end(link.first), start(link.second))) {
+            error = "Linked sides " + name(link.first) + " and " +
+                    name(link.second) + " aren't shared.";
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Number of pairs of edges of `edges` with the same vertices, in
+/// either order: shared sides which weren't moved to `links`, or sides
+/// stored twice.
+std::size_t Tiling::countOverlappingEdges() const {
+    auto start = [this](const Edge& edge) {
+        return geometry.getVertex(edge.polygon->getId(), edge.edge);
+    };
+    auto end = [this](const Edge& edge) {
+        return geometry.getVertex(edge.polygon->getId(), edge.edge + 1);
+    };
+    // edges sorted by the x of their midpoint, only those closer than the
+    // threshold can overlap
+    std::size_t count = 0;
+    std::vector<std::pair<double, const Edge*>> sorted{};
+    sorted.reserve(edges.size());
+    for (auto& edge : edges) {
+        sorted.emplace_back((start(edge).x + end(edge).x) / 2.0, &edge);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t n = 0; n < sorted.size(); n++) {
+        const Edge& edge = *sorted[n].second;
+        for (std::size_t other = n + 1;
+             other < sorted.size() &&
+             sorted[other].first - sorted[n].first < DISTANCE_THRESHOLD;
+             other++) {
+            const Edge& otherEdge = *sorted[other].second;
+            if ((isNear(start(edge), end(otherEdge)) &&
+                 isNear(end(edge), start(otherEdge))) ||
+                (isNear(start(edge), start(otherEdge)) &&
+                 isNear(end(edge), end(otherEdge)))) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void Tiling::removeAllPolygons() {
+    edges.clear();
+    edgePositions.clear();
+    polygons.clear();
+    links.clear();
+    geometry.clear();
+    graph.clear();
+    vertices.clear();
+    currentEdge = edges.cbegin();
+    recordChange(0);
+}
+
+/// @brief Move the edge cursor to the next accessible edge.
+void Tiling::nextEdge() { currentEdge = circularNext(currentEdge); }
+
+/// @brief Move the edge cursor to the previous accessible edge.
+void Tiling::prevEdge() { currentEdge = circularPrev(currentEdge); }
+
+static double distanceToSegment(const dvec2& point, const dvec2& a,
+                                const dvec2& b) {
+    dvec2 side = b - a;
+    double t = glm::clamp(dot(point - a, side) / dot(side, side), 0.0, 1.0);
+    return distance(point, a + t * side);
+}
+
+/// @brief Move the edge cursor to the accessible edge nearest to `point`.
+/// If `point` is inside a polygon with accessible edges, the nearest of them
+/// is chosen instead.
+///
+/// Polygons are searched in boxes around `point` doubling in size, using the
+/// polygon index of `geometry`.
+/// @param point world coordinates
+/// @return whether the cursor was moved
+bool Tiling::pickEdge(const dvec2& point) {
+    if (edges.empty()) {
+        return false;
+    }
+    auto best = edgePositions.cend();
+    double bestDistance = INFINITY;
+    auto findNearest = [&](const std::vector<int>& ids) {
+        for (int id : ids) {
+            for (int side = 0; side < polygons[id]->nbSides; side++) {
+                auto position = edgePositions.find(Edge(polygons[id], side));
+                if (position == edgePositions.cend()) {
+                    continue;
+                }
+                double distance =
+                    distanceToSegment(point, geometry.getVertex(id, side),
+                                      geometry.getVertex(id, side + 1));
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = position;
+                }
+            }
+        }
+    };
+    int polygon = geometry.findPolygon(point);
+    if (polygon >= 0) {
+        findNearest(std::vector<int>{polygon});
+    }
+    std::vector<int> ids{};
+    // an edge at `radius` or less from `point` has its polygon in the box
+    double radius = 0.25;
+    while (best == edgePositions.cend()) {
+        geometry.findPolygons(point - dvec2(radius), point + dvec2(radius),
+                              ids);
+        findNearest(ids);
+        if (static_cast<int>(ids.size()) == geometry.size()) {
+            break;
+        } else if (bestDistance > radius) {
+            // a nearer edge may be outside of the box
+            best = edgePositions.cend();
+            bestDistance = INFINITY;
+        }
+        radius *= 2.0;
+    }
+    if (best == edgePositions.cend()) {
+        return false;
+    }
+    currentEdge = best->second;
+    return true;
+}
+
+/// @brief Recompute `geometry`, `graph` and `vertices` from scratch, with
+/// passes split over ranges of polygon ids on `pool`.
+/// The result doesn't depend on the number of threads.
+/// @param pool
+void Tiling::rebuild(ThreadPool& pool) {
+    geometry.build(polygons, pool);
+    graph.build(polygons, geometry, pool);
+    vertices.build(polygons, pool);
+}
+
+const std::vector<std::shared_ptr<Polygon>>& Tiling::getPolygons() const {
+    return polygons;
+}
+
+const std::list<Edge>& Tiling::getEdges() const { return edges; }
+
+/// @brief Edge under the cursor, nullptr if there are no polygons.
+const Edge* Tiling::getCurrentEdge() const {
+    return currentEdge != edges.cend() ? &*currentEdge : nullptr;
+}
+
+const WorldGeometry& Tiling::getGeometry() const { return geometry; }
+
+const AdjacencyGraph& Tiling::getGraph() const { return graph; }
+
+const VertexClassifier& Tiling::getVertices() const { return vertices; }
+
+unsigned Tiling::getRevision() const { return revision; }
+
+/// @brief What the last revisions changed, oldest first, ending with the
+/// current revision unless no polygon was ever changed.
+const std::deque<TilingChange>& Tiling::getChanges() const { return changes; }
+
+/// @brief Start a new revision, which changed the polygons from `firstId` on.
+void Tiling::recordChange(const int firstId) {
+    revision++;
+    changes.emplace_back(revision, firstId);
+    if (changes.size() > MAX_CHANGES) {
+        changes.pop_front();
+    }
+}
+
+/// @brief Insert `edge` in `edges` before `position`, keeping
+/// `edgePositions` up to date.
+/// @return position of the inserted edge
+std::list<Edge>::const_iterator
+Tiling::insertEdge(std::list<Edge>::const_iterator position, const Edge& edge) {
+    auto inserted = edges.insert(position, edge);
+    edgePositions[edge] = inserted;
+    return inserted;
+}
+
+/// @brief Erase `edge` from `edges`, keeping `edgePositions` up to date.
+/// @return position following the erased edge
+std::list<Edge>::const_iterator
+Tiling::eraseEdge(std::list<Edge>::const_iterator edge) {
+    edgePositions.erase(*edge);
+    return edges.erase(edge);
+}
+
+std::list<Edge>::const_iterator
+Tiling::circularNext(std::list<Edge>::const_iterator& edge) const {
+    if (edges.empty()) {
+        return edge;
+    }
+    auto incremented = std::next(edge);
+    if (incremented == edges.cend()) {
+        incremented = edges.cbegin();
+    }
+    return incremented;
+}
+
+std::list<Edge>::const_iterator
+Tiling::circularPrev(std::list<Edge>::const_iterator& edge) const {
+    if (edges.empty()) {
+        return edge;
+    }
+    auto toDecrement = edge;
+    if (toDecrement == edges.cbegin()) {
+        toDecrement = edges.cend();
+    }
+    return std::prev(toDecrement);
+}
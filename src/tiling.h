@@ -0,0 +1,136 @@
+#ifndef TILING_H
+#define TILING_H
+
+#include "adjacencyGraph.h"
+#include "edge.h"
+#include "memoryUsage.h"
+#include "polygon.h"
+#include "threadPool.h"
+#include "tilingFile.h"
+#include "vertexClassifier.h"
+#include "worldGeometry.h"
+#include <deque>
+#include <functional>
+#include <glm/vec2.hpp>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Polygons changed by a revision of a Tiling: the polygons from id
+/// `firstId` on may have been added, removed or recolored, the others are
+/// unchanged.
+struct TilingChange {
+    unsigned revision{};
+    int firstId{};
+    TilingChange(const unsigned revision, const int firstId)
+        : revision(revision), firstId(firstId) {};
+};
+
+/// @brief Manages Polygon instances and an edge cursor. Non-copyable.
+///
+/// @arg `currentEdge` Edge cursor that you can move from edge to edge to
+/// choose where to add a new polygon.
+/// This cursor can only access polygon sides stored in `edges`.
+///
+/// @arg `edges` Polygon sides accessible by the edge cursor `currentEdge`.
+/// Linked list with bidirectional circular traversal using
+/// `Tiling::circularNext` and `Tiling::circularPrev`.
+///
+/// @arg `edgePositions` Position of each edge of `edges` in the list, to move
+/// the cursor to a given edge.
+///
+/// @arg `links` Shared Polygon sides unreachable by the edge cursor
+/// `currentEdge`. Hashmap mapping edge to edge.
+///
+/// @arg `geometry` World-space vertices and bounding boxes of the polygons,
+/// used to cull polygons outside of the view and to find shared sides.
+///
+/// @arg `graph` Polygons sharing a side, detected geometrically (including
+/// the overlaps missing from `links`). Used to color polygons.
+///
+/// @arg `vertices` Vertices of the polygons classified by vertex
+/// configuration, updated on each addition and removal.
+///
+/// @note
+/// In principle, overlapping/shared edges of connected polygons should be
+/// stored in `links` while other edges should be stored in
+/// `edges`. In practice, the detection of overlapping edges when instantiating
+/// a new polygon is not perfect. There can remain undetected overlapping
+/// polygon sides in `edges`. However, the current implementation has the useful
+/// feature that adjacent elements in `edges` are always adjacent sides, and
+/// that polygons are always all connected.
+class Tiling {
+    std::vector<std::shared_ptr<Polygon>> polygons{};
+    std::list<Edge>::const_iterator currentEdge{};
+    std::list<Edge> edges{};
+    std::unordered_map<Edge, std::list<Edge>::const_iterator, EdgeHash>
+        edgePositions{};
+    std::unordered_map<Edge, Edge, EdgeHash> links{};
+    WorldGeometry geometry{};
+    AdjacencyGraph graph{};
+    VertexClassifier vertices{};
+    // changes whenever polygons are added, removed or recolored
+    unsigned revision{};
+    // what the last revisions changed, oldest first
+    std::deque<TilingChange> changes{};
+
+    std::list<Edge>::const_iterator
+    circularNext(std::list<Edge>::const_iterator& edge) const;
+    std::list<Edge>::const_iterator
+    circularPrev(std::list<Edge>::const_iterator& edge) const;
+    std::list<Edge>::const_iterator
+    insertEdge(std::list<Edge>::const_iterator position, const Edge& edge);
+    std::list<Edge>::const_iterator
+    eraseEdge(std::list<Edge>::const_iterator edge);
+    bool overlapsPolygons(const Polygon& polygon) const;
+    void linkEdges(const int firstId);
+    void recordChange(const int firstId);
+
+  public:
+    Tiling();
+    Tiling(const Tiling&) = delete;
+    Tiling& operator=(const Tiling&) = delete;
+    void addPolygon(int nbSides);
+    bool canAddPolygon(const int nbSides) const;
+    int addPolygons(int nbSides,
+                    const std::function<bool(const Edge&)>& predicate);
+    void removeAllPolygons();
+    void removeLastPolygon();
+    bool canRemoveLastPolygon() const;
+    void recolorAllPolygons();
+    void nextEdge();
+    void prevEdge();
+    bool pickEdge(const glm::dvec2& point);
+    void rebuild(ThreadPool& pool);
+    void exportDualGraph(const std::string& filename, ThreadPool& pool) const;
+    void save(const std::string& filename) const;
+    bool load(const TilingRecord& record);
+    void exportSvg(const std::string& filename) const;
+    void exportSvg(const std::string& filename, const glm::dvec2& min,
+                   const glm::dvec2& max) const;
+    const std::vector<std::shared_ptr<Polygon>>& getPolygons() const;
+    const std::list<Edge>& getEdges() const;
+    const Edge* getCurrentEdge() const;
+    const WorldGeometry& getGeometry() const;
+    const AdjacencyGraph& getGraph() const;
+    const VertexClassifier& getVertices() const;
+    unsigned getRevision() const;
+    const std::deque<TilingChange>& getChanges() const;
+    void getMemoryUsage(MemoryUsage& usage) const;
+    bool checkInvariants(std::string& error) const;
+    std::size_t countOverlappingEdges() const;
+    void debug() const;
+};
+
+static_assert(!std::is_copy_constructible<Tiling>::value,
+              "Tiling shouldn't be copy constructible.");
+static_assert(!std::is_copy_assignable<Tiling>::value,
+              "Tiling shouldn't be copy assignable.");
+static_assert(!std::is_move_constructible<Tiling>::value,
+              "Tiling shouldn't be move constructible.");
+static_assert(!std::is_move_assignable<Tiling>::value,
+              "Tiling shouldn't be move assignable.");
+
+#endif /* TILING_H */
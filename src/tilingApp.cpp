@@ -1,240 +1,519 @@
 #include "tilingApp.h"
-#include "edge.h"
-#include "program.h"
 #include "utils.h"
 #include <algorithm>
-#include <cassert>
-#include <glad/glad.h>
+#include <chrono>
+#include <cmath>
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
-#include <glm/gtc/type_ptr.hpp>
-#include <glm/mat3x2.hpp>
+#include <glm/glm.hpp>
 #include <iostream>
+#include <thread>
+
+// half size of the largest region covered by a substitution patch
+static const double MAX_PATCH_EXTENT = 16.0;
+// hyperbolic tilings shown by successive presses on H
+static const int HYPERBOLIC_SYMBOLS[][2] = {
+    {7, 3}, {5, 4}, {4, 5}, {3, 7}, {6, 4}};
+static const int NB_HYPERBOLIC_SYMBOLS = 5;
+// file written by S and read by L
+static const char* TILING_FILE = "tiling.txt";
+// records of a tiling file applied between two published scenes
+static const int LOAD_BATCH = 20000;
 
 TilingApp::TilingApp(GLFWwindow* window) : window(window) {
-    assert(createMinimalProgram(shaderProgram));
-    glUseProgram(shaderProgram);
-    int positionUniform = glGetUniformLocation(shaderProgram, "windowSize");
-    glUniform2f(positionUniform, 1.0, 1.0);
     initGlfwCallbacks();
-    currentEdge = edges.cbegin();
-    viewMatrix = glm::mat3x2(1.0);
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    framebufferSizeCallback(window, width, height);
+    // initial scene with the cursor only
+    editor.submit([this]() { publishScene(); });
     log(" was " GREEN "created" RESET ".");
 }
 
 TilingApp::~TilingApp() {
-    destroyGL();
     glfwSetWindowUserPointer(window, nullptr);
     log(" was " RED "deleted" RESET ".");
 }
 
-/// @brief Create a Polygon with `nbSides` on the position of `currentEdge`.
-/// The new polygon sides are stored in `edges` or `links`.
-///
-/// First all new edges are stored in `edges`. Then overlapping edges
-/// contiguous in `edges` are detected and moved to `links`. Non-contiguous
-/// overlapping edges aren't detected and remain stored in `edges`.
-/// @param nbSides
-void TilingApp::addPolygon(int nbSides) {
-    if (polygons.empty()) {
-        polygons.emplace_back(new Polygon(nbSides));
-        for (int i = 0; i < nbSides; i++) {
-            edges.emplace_back(polygons.back(), i);
-        }
-        currentEdge = edges.cbegin();
-        polygons.back()->setColor(PolygonColor{});
-    } else {
-        // create new polygon
-        polygons.emplace_back(new Polygon(nbSides));
-        polygons.back()->bindTo(currentEdge->polygon, currentEdge->edge);
-        // create a list of this polygon edges
-        auto newEdges = std::list<Edge>{};
-        for (int i = 0; i < nbSides; i++) {
-            newEdges.emplace_back(polygons.back(), i);
+/// @brief Handle window events until the window should close, or replay the
+/// recorded events, while a render thread draws the latest scene.
+/// @note The OpenGL context of the window must be current on the calling
+/// thread. It is released during the call and made current again after.
+void TilingApp::run() {
+    running = true;
+    glfwMakeContextCurrent(nullptr);
+    std::thread renderThread(&TilingApp::renderLoop, this);
+    if (replaying) {
+        runReplay();
+    }
+    while (!glfwWindowShouldClose(window)) {
+        glfwWaitEvents();
+        // collect the events of a whole frame before applying them
+        waitForFrame();
+        glfwPollEvents();
+        if (recorder) {
+            InputEvent frame{};
+            frame.time = glfwGetTime() - inputStart;
+            recorder->record(frame);
         }
-        // store the new edges in `edges` (between iterators `left` and `right`)
-        auto right = circularNext(currentEdge);
-        std::list<Edge>::const_iterator left =
-            edges.insert(right, newEdges.cbegin(), newEdges.cend());
-        std::vector<bool> neighborColors(11, true);
-        // for any consecutive overlapping edges
-        // (1) update `links` (insert the two overlapping edges)
-        // (2) update `edges` (remove the two overlapping edges)
-        // /!\ pay attention not to invalidate `left`
-        while (right->connectedTo(*circularPrev(right))) {
-            if (circularPrev(right)->polygon == polygons.back()) {
-                neighborColors[right->polygon->getColorIndex()] = false;
+        processInput();
+    }
+    if (recorder && !recorder->close()) {
+        logError("Failed to write the input file.");
+    }
+    running = false;
+    renderThread.join();
+    glfwMakeContextCurrent(window);
+}
+
+/// @brief Record the events of the window to `filename` from now on, see
+/// `InputRecorder`, starting with the size of the view.
+/// @return whether the file was created, errors are logged
+bool TilingApp::record(const std::string& filename) {
+    recorder.reset(new InputRecorder(filename));
+    if (!recorder->isValid()) {
+        recorder.reset();
+        return false;
+    }
+    inputStart = glfwGetTime();
+    InputEvent resize{};
+    resize.type = InputEventType::resize;
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        resize.code = view.width;
+        resize.action = view.height;
+    }
+    recorder->record(resize);
+    return true;
+}
+
+/// @brief Replay the events recorded in `filename` when running, instead of
+/// handling those of the window, then close the window.
+/// @param filename
+/// @param fast whether to replay as fast as possible, rather than at the
+/// recorded times
+/// @return whether the file was read, errors are logged
+bool TilingApp::replay(const std::string& filename, const bool fast) {
+    if (!readInputEvents(filename, replayed)) {
+        return false;
+    }
+    replaying = true;
+    replayFast = fast;
+    return true;
+}
+
+/// @brief Feed the recorded events back one frame at a time, then print
+/// their latency to std::cout and close the window.
+///
+/// Each frame handles the events recorded for it, then waits until the edit
+/// thread has applied them and the render thread has swapped a frame
+/// started after that. The latency of an event is measured from when it is
+/// handled to that swap, and the latency of a frame from `processInput` to
+/// that swap.
+void TilingApp::runReplay() {
+    LatencyStats eventLatency{}, frameLatency{};
+    // GLFW times at which the events of the frame were handled
+    std::vector<double> handled{};
+    inputStart = glfwGetTime();
+    std::size_t next = 0;
+    while (next < replayed.size() && !glfwWindowShouldClose(window)) {
+        // the events of the window are ignored, but closing it stops
+        glfwPollEvents();
+        handled.clear();
+        for (; next < replayed.size(); next++) {
+            const InputEvent& event = replayed[next];
+            const double delay = inputStart + event.time - glfwGetTime();
+            if (!replayFast && delay > 0.0) {
+                std::this_thread::sleep_for(
+                    std::chrono::duration<double>(delay));
             }
-            // cf (1)
-            links.emplace(*right, *circularPrev(right));
-            links.emplace(*circularPrev(right), *right);
-            // cf /!\ .
-            if (circularPrev(right) == left) {
-                left = circularNext(right);
-                // cf (2)
-                edges.erase(circularPrev(right));
-                right = circularNext(right);
-                edges.erase(circularPrev(right));
+            if (event.type == InputEventType::frame) {
+                next++;
                 break;
             }
-            // cf (2)
-            edges.erase(circularPrev(right));
-            right = circularNext(right);
-            edges.erase(circularPrev(right));
-        }
-        while (left->connectedTo(*circularPrev(left))) {
-            if (left->polygon == polygons.back()) {
-                neighborColors[circularPrev(left)->polygon->getColorIndex()] =
-                    false;
-            }
-            // cf (1)
-            links.emplace(*left, *circularPrev(left));
-            links.emplace(*circularPrev(left), *left);
-            // cf (2)
-            edges.erase(circularPrev(left));
-            left = circularNext(left);
-            edges.erase(circularPrev(left));
+            handled.push_back(glfwGetTime());
+            handleEvent(event);
         }
-        currentEdge = left;
-        /* for (auto aha : neighborColors) {
-            std::clog << aha << ", ";
+        const double frameStart = glfwGetTime();
+        processInput();
+        waitForEdits();
+        // the frame being drawn may show the previous scene
+        waitForFrames(2);
+        const double swapped = glfwGetTime();
+        frameLatency.add(swapped - frameStart);
+        for (double time : handled) {
+            eventLatency.add(swapped - time);
         }
-        std::clog << std::endl; */
-        int idx = 0;
-        while (!neighborColors[idx]) {
-            idx++;
+    }
+    std::cout << "Replayed in " << glfwGetTime() - inputStart << "s."
+              << std::endl;
+    eventLatency.report(std::cout, "Events");
+    frameLatency.report(std::cout, "Frames");
+    replaying = false;
+    glfwSetWindowShouldClose(window, GLFW_TRUE);
+}
+
+void TilingApp::debug() {
+    editor.submit([this]() {
+        tiling.debug();
+        reportMemory();
+    });
+}
+
+/// @brief Print the bytes used by each subsystem of the tiling and by the
+/// GPU buffers. Must run on the edit thread.
+void TilingApp::reportMemory() const {
+    MemoryUsage usage{};
+    tiling.getMemoryUsage(usage);
+    usage.gpuBuffers = gpuBufferBytes;
+    usage.report(std::clog, tiling.getPolygons().size());
+}
+
+/// @brief Draw the latest published scene until `running` is cleared.
+void TilingApp::renderLoop() {
+    glfwMakeContextCurrent(window);
+    {
+        Renderer renderer{(GLADloadproc)glfwGetProcAddress};
+        bool firstFrame = true;
+        while (running) {
+            scenes.update();
+            View current{};
+            {
+                std::lock_guard<std::mutex> lock(viewMutex);
+                current = view;
+            }
+            renderer.render(scenes.getFront(), current);
+            gpuBufferBytes = renderer.getBufferBytes();
+            glfwSwapBuffers(window);
+            {
+                std::lock_guard<std::mutex> lock(frameMutex);
+                frameCount++;
+            }
+            frameSwapped.notify_all();
+            if (firstFrame) {
+                // GLFW time starts at initialization
+                std::clog << "First frame after " << glfwGetTime() << "s."
+                          << std::endl;
+                firstFrame = false;
+            }
         }
-        polygons.back()->setColor(static_cast<PolygonColor>(idx));
+        // delete GL objects while the context is current
     }
+    glfwMakeContextCurrent(nullptr);
 }
 
-/// @brief Remove the Polygon created last. Variables `edges` and `links` are
-/// updated accordingly.
-///
-/// First, edges overlapping with the most recent polygon are added to `edges`
-/// and removed from `links`. Then the sides from the last polygon are
-/// removed from `edges` and the polygon is removed from `polygons`.
-///
-/// @note This implementation supposes that the edges of the last polygon are
-/// all adjacent in `edges` (there sequential in the _circular_ list, but may
-/// not be sequential in the underlying list).
-///
-/// @note Removing the polygon pointed by `currentEdge` instead of the last
-/// polygon might result in polygons not being linked anymore.
-void TilingApp::removeLastPolygon() {
-    if (polygons.empty()) {
-        return;
-    } else if (polygons.size() == 1) {
-        removeAllPolygons();
-        return;
+/// @brief Wait until the render thread swaps the next frame, or a few
+/// frames at most if it is stalled.
+void TilingApp::waitForFrame() {
+    std::unique_lock<std::mutex> lock(frameMutex);
+    const unsigned frame = frameCount;
+    frameSwapped.wait_for(lock, std::chrono::milliseconds(50),
+                          [this, frame]() { return frameCount != frame; });
+}
+
+/// @brief Wait until the render thread swaps `nbFrames` more frames.
+void TilingApp::waitForFrames(const unsigned nbFrames) {
+    std::unique_lock<std::mutex> lock(frameMutex);
+    const unsigned frame = frameCount;
+    frameSwapped.wait(lock, [this, frame, nbFrames]() {
+        return frameCount - frame >= nbFrames;
+    });
+}
+
+/// @brief Wait until the edit thread has run the tasks submitted so far.
+void TilingApp::waitForEdits() {
+    std::mutex doneMutex{};
+    std::condition_variable done{};
+    bool finished = false;
+    editor.submit([&]() {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        finished = true;
+        done.notify_one();
+    });
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&finished]() { return finished; });
+}
+
+/// @brief Apply the input of the frame: one view update, then the queued
+/// edits as a single task on the edit thread.
+void TilingApp::processInput() {
+    glm::dvec2 delta = input.takeCursorDelta();
+    if (delta.x != 0.0 || delta.y != 0.0) {
+        handleScroll(delta.x / 30.0, delta.y / 30.0);
     }
-    auto lastPolygon = polygons.back();
-    std::clog << lastPolygon.get() << std::endl;
-    // TODO using a const iterator is not needed so no need to use it
-    std::list<Edge>::const_iterator left =
-        std::find_if(edges.begin(), edges.end(), [lastPolygon](Edge& edge) {
-            return (edge.polygon == lastPolygon);
-        });
-    std::list<Edge>::const_reverse_iterator _right =
-        std::find_if(edges.rbegin(), edges.rend(), [lastPolygon](Edge& edge) {
-            return (edge.polygon == lastPolygon);
-        });
-    if (left == edges.end() || _right == edges.rend()) {
-        // FIXME
-        logError("Removal of a polygon with no accessible sides is not "
-                 "implemented yet.");
-        return;
+    int zoomSteps = input.takeZoomSteps();
+    if (zoomSteps) {
+        zoom(zoomSteps);
     }
-    std::clog << "Left:" << left->polygon.get() << " " << left->edge
-              << std::endl;
-    std::clog << "_right:" << _right->polygon.get() << " " << _right->edge
-              << std::endl;
-    auto right = std::prev(_right.base());
-    std::clog << "Right:" << right->polygon.get() << " " << right->edge
-              << std::endl;
-    if (left->edge > right->edge) {
-        std::clog << "Circular list trouble." << std::endl;
-        // Unfortunately lastPolygon edges aren't sequential as they span the
-        // end and begining of the list.
-        auto futureRight =
-            std::find_if(edges.begin(), edges.end(), [lastPolygon](Edge& edge) {
-                return (edge.polygon != lastPolygon);
-            });
-        edges.splice(edges.cend(), edges, edges.cbegin(), futureRight);
-        removeLastPolygon();
-        return;
+    // finished chunks of the periodic tiling also wake the main thread
+    if (delta.x != 0.0 || delta.y != 0.0 || zoomSteps ||
+        periodic.hasReadyChunks()) {
+        const bool recentered = recenterView();
+        input.query([this, recentered]() {
+            // the positions of the scene are relative to the view origin,
+            // except on the hyperbolic disk
+            if (updateDisplay() ||
+                (recentered && display != Display::hyperbolic)) {
+                publishScene();
+            }
+        });
     }
-    debug();
-    int rightEdge = right->edge;
-    right = std::next(right);
-    for (int side = rightEdge + 1; side <= lastPolygon->nbSides - 1; side++) {
-        auto edge = Edge{lastPolygon, side};
-        auto linkedEdge = links.at(edge);
-        right = edges.insert(right, linkedEdge);
-        links.erase(edge);
-        links.erase(linkedEdge);
+    auto edits = input.takeEdits([this]() { publishScene(); });
+    if (edits) {
+        editor.submit(edits);
     }
-    debug();
-    for (int side = left->edge - 1; side >= 0; side--) {
-        auto edge = Edge{lastPolygon, side};
-        auto linkedEdge = links.at(edge);
-        edges.insert(left, linkedEdge);
-        links.erase(edge);
-        links.erase(linkedEdge);
+}
+
+/// @brief Queue `function` to modify the tiling on the edit thread with the
+/// other edits of the frame, after which the resulting scene is published.
+/// Edits are rejected while a tiling is loaded, see `loadBatch`.
+/// @param function
+void TilingApp::edit(const std::function<void()>& function) {
+    input.edit([this, function]() {
+        if (loading) {
+            logError("The tiling is still loading.");
+            return;
+        }
+        function();
+    });
+}
+
+void TilingApp::publishScene() {
+    Scene& scene = scenes.getBack();
+    glm::dvec2 origin{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        origin = view.origin;
     }
-    if (currentEdge->polygon == lastPolygon) {
-        currentEdge = circularPrev(left);
+    switch (display) {
+        case Display::tiling:
+            scene.capture(tiling, origin);
+            break;
+        case Display::patch:
+            scene.capture(patch, origin);
+            break;
+        case Display::hyperbolic:
+            scene.capture(hyperbolic);
+            break;
+        case Display::periodic:
+            scene.capture(periodic, origin);
+            break;
     }
-    debug();
-    std::clog << "currentEdge" << currentEdge->polygon.get() << " "
-              << currentEdge->edge << std::endl;
-    edges.erase(left, right);
-    debug();
-    polygons.pop_back();
-}
-
-void TilingApp::debug() const {
-    /* for (auto& polygon : polygons) {
-        polygon->debug();
-    } */
-    for (auto& edge : edges) {
-        std::clog << edge.polygon.get() << " " << edge.edge << std::endl;
+    scene.version = ++publishCount;
+    scenes.publish();
+}
+
+/// @brief Add a polygon on the edge cursor, or with Ctrl on every accessible
+/// edge of the polygons with as many sides as the one under the cursor, or
+/// with Alt on every accessible edge where it fits between its neighbors.
+/// @param nbSides
+/// @param mods GLFW modifier keys
+void TilingApp::addPolygon(const int nbSides, const int mods) {
+    if (mods & GLFW_MOD_CONTROL) {
+        edit([this, nbSides]() {
+            const Edge* cursor = tiling.getCurrentEdge();
+            if (!cursor) {
+                return;
+            }
+            const int cursorSides = cursor->polygon->nbSides;
+            tiling.addPolygons(nbSides, [cursorSides](const Edge& edge) {
+                return edge.polygon->nbSides == cursorSides;
+            });
+        });
+    } else if (mods & GLFW_MOD_ALT) {
+        edit([this, nbSides]() {
+            const VertexClassifier& vertices = tiling.getVertices();
+            // interior angle of the new polygon, with some tolerance
+            const float angle =
+                glm::pi<float>() * (nbSides - 2) / nbSides - 1e-3;
+            tiling.addPolygons(nbSides, [&vertices, angle](const Edge& edge) {
+                glm::dvec2 a = edge.polygon->getVertex(edge.edge);
+                glm::dvec2 b = edge.polygon->getVertex(edge.edge + 1);
+                return vertices.getFreeAngle(a) >= angle &&
+                       vertices.getFreeAngle(b) >= angle;
+            });
+        });
+    } else {
+        edit([this, nbSides]() { tiling.addPolygon(nbSides); });
     }
-    std::clog << std::endl;
 }
-void TilingApp::render() const {
 
-    glClear(GL_COLOR_BUFFER_BIT);
+/// @brief Remove the Polygon created last, see `Tiling::removeLastPolygon`.
+void TilingApp::removeLastPolygon() {
+    edit([this]() {
+        if (tiling.getPolygons().size() == 1) {
+            resetViewCenter();
+        }
+        tiling.removeLastPolygon();
+    });
+}
+
+void TilingApp::removeAllPolygons() {
+    edit([this]() {
+        tiling.removeAllPolygons();
+        resetViewCenter();
+    });
+}
+
+/// @brief Rebuild the tiling geometry, adjacency graph and vertex
+/// classification from scratch on `pool`, and print how long it took.
+void TilingApp::rebuild() {
+    edit([this]() {
+        double start = glfwGetTime();
+        tiling.rebuild(pool);
+        std::clog << "Tiling rebuilt in " << glfwGetTime() - start
+                  << "s using " << pool.size() << " threads." << std::endl;
+    });
+}
+
+/// @brief Show the patch of `substitution` instead of the tiling, or the
+/// tiling again if this patch is already shown.
+/// @param substitution
+void TilingApp::togglePatch(const Substitution substitution) {
+    edit([this, substitution]() {
+        if (display == Display::patch &&
+            patch.getSubstitution() == substitution) {
+            display = Display::tiling;
+            return;
+        }
+        display = Display::patch;
+        patch.setSubstitution(substitution);
+        updatePatch();
+    });
+}
+
+/// @brief Show the first of `HYPERBOLIC_SYMBOLS` instead of the tiling, or
+/// the next one if a hyperbolic tiling is already shown, or the tiling
+/// again after the last one.
+void TilingApp::nextHyperbolic() {
+    edit([this]() {
+        int next = 0;
+        if (display == Display::hyperbolic) {
+            while (HYPERBOLIC_SYMBOLS[next][0] != hyperbolic.getP() ||
+                   HYPERBOLIC_SYMBOLS[next][1] != hyperbolic.getQ()) {
+                next++;
+            }
+            next++;
+        }
+        if (next == NB_HYPERBOLIC_SYMBOLS) {
+            display = Display::tiling;
+            return;
+        }
+        display = Display::hyperbolic;
+        hyperbolic.setSymbol(HYPERBOLIC_SYMBOLS[next][0],
+                             HYPERBOLIC_SYMBOLS[next][1]);
+        updateHyperbolic();
+    });
+}
+
+/// @brief Show the first periodic tiling preset instead of the tiling, or
+/// the next one if a periodic tiling is already shown, or the tiling again
+/// after the last one.
+void TilingApp::nextPeriodic() {
+    edit([this]() {
+        int next = 0;
+        if (display == Display::periodic) {
+            next = periodic.getPreset() + 1;
+        }
+        if (next == PeriodicTiling::getNbPresets()) {
+            display = Display::tiling;
+            return;
+        }
+        display = Display::periodic;
+        periodic.setPreset(next);
+        std::clog << "Showing the periodic tiling " << periodic.getName()
+                  << "." << std::endl;
+        updatePeriodic();
+    });
+}
 
-    glUseProgram(shaderProgram);
-    int positionUniform = glGetUniformLocation(shaderProgram, "view3x2");
-    glUniformMatrix3x2fv(positionUniform, 1, GL_FALSE, value_ptr(viewMatrix));
+/// @brief Inflate the patch or add layers to the hyperbolic tiling `steps`
+/// more times, or fewer if negative, depending on what is shown.
+void TilingApp::changeDepth(const int steps) {
+    edit([this, steps]() {
+        if (display == Display::patch) {
+            patch.setDepth(patch.getDepth() + steps);
+        } else if (display == Display::hyperbolic) {
+            hyperbolic.setDepth(hyperbolic.getDepth() + steps);
+        }
+        updateDisplay();
+    });
+}
 
-    for (auto& polygon : polygons) {
-        polygon->render(shaderProgram);
+/// @brief Generate what is shown for the current view if needed.
+/// @return whether it was generated
+bool TilingApp::updateDisplay() {
+    switch (display) {
+        case Display::patch:
+            return updatePatch();
+        case Display::hyperbolic:
+            return updateHyperbolic();
+        case Display::periodic:
+            return updatePeriodic();
+        default:
+            return false;
     }
-    for (auto& edge : edges) {
-        edge.underline(shaderProgram);
+}
+
+/// @brief Generate the patch around the visible region, unless the last
+/// generated one still covers it. Runs on the edit thread.
+/// @return whether the patch was generated
+bool TilingApp::updatePatch() {
+    glm::dvec2 min{}, max{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        view.getVisibleBounds(min, max);
     }
-    if (currentEdge != edges.cend()) {
-        currentEdge->highlight(shaderProgram);
-    } else {
-        std::unique_ptr<Polygon> dummyPolygon(new Polygon(2, false));
-        dummyPolygon->highlightEdge(shaderProgram, 0);
+    // zoomed far out, only the center of the view is covered
+    glm::dvec2 center = (min + max) / 2.0;
+    glm::dvec2 extent =
+        glm::min((max - min) / 2.0, glm::dvec2(MAX_PATCH_EXTENT / 2.0));
+    if (patch.covers(center - extent, center + extent)) {
+        return false;
     }
-
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    // generate ahead so that small moves don't regenerate the patch
+    double start = glfwGetTime();
+    patch.generate(center - 2.0 * extent, center + 2.0 * extent, pool);
+    std::clog << "Generated " << patch.getTiles().size()
+              << " prototiles at depth " << patch.getDepth() << " in "
+              << glfwGetTime() - start << "s." << std::endl;
+    return true;
 }
 
-void TilingApp::log(const char* log) const {
-    std::clog << "TilingApp" << log << std::endl;
+/// @brief Generate the hyperbolic tiling down to the pixel size, unless it
+/// was generated for the current zoom. Runs on the edit thread.
+/// @return whether the tiling was generated
+bool TilingApp::updateHyperbolic() {
+    float pixelSize{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        pixelSize = view.getPixelSize();
+    }
+    if (hyperbolic.covers(pixelSize)) {
+        return false;
+    }
+    double start = glfwGetTime();
+    hyperbolic.generate(pixelSize);
+    std::clog << "Generated " << hyperbolic.getTiles().size() << " tiles of {"
+              << hyperbolic.getP() << ", " << hyperbolic.getQ() << "} in "
+              << glfwGetTime() - start << "s." << std::endl;
+    return true;
 }
 
-void TilingApp::destroyGL(const bool destroyProgram) {
-    if (destroyProgram && (shaderProgram)) {
-        glDeleteProgram(shaderProgram);
+/// @brief Keep the chunks of the periodic tiling finished so far and
+/// request those around the visible region. Runs on the edit thread.
+/// @return whether the kept chunks changed
+bool TilingApp::updatePeriodic() {
+    glm::dvec2 min{}, max{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        view.getVisibleBounds(min, max);
     }
+    return periodic.update(min, max, pool);
+}
+
+void TilingApp::log(const char* log) const {
+    std::clog << "TilingApp" << log << std::endl;
 }
 
 void TilingApp::initGlfwCallbacks() {
@@ -243,95 +522,157 @@ void TilingApp::initGlfwCallbacks() {
     glfwSetFramebufferSizeCallback(window, TilingApp::framebufferSizeCallback);
     glfwSetWindowMaximizeCallback(window, TilingApp::windowMaximizeCallback);
     glfwSetCursorPosCallback(window, TilingApp::cursorPosCallback);
+    glfwSetMouseButtonCallback(window, TilingApp::mouseButtonCallback);
 }
 
-void TilingApp::removeAllPolygons() {
-    edges.clear();
-    polygons.clear();
-    links.clear();
-    currentEdge = edges.cbegin();
-    resetViewCenter();
+/// @brief Move the edge cursor to the edge nearest to the window center,
+/// marked by a crosshair (the mouse pointer is hidden and moves the view).
+void TilingApp::pickEdge() {
+    glm::dvec2 point{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        point = view.unproject(glm::vec2(0.0, 0.0));
+    }
+    edit([this, point]() { tiling.pickEdge(point); });
 }
 
-std::list<Edge>::const_iterator
-TilingApp::circularNext(std::list<Edge>::const_iterator& edge) const {
-    if (edges.empty()) {
-        return edge;
+/// @brief Write the polygons to `tiling.svg` on the editor thread, only
+/// those in the view if `clipToView`.
+void TilingApp::exportSvg(const bool clipToView) {
+    if (!clipToView) {
+        input.query([this]() { tiling.exportSvg("tiling.svg"); });
+        return;
     }
-    auto incremented = std::next(edge);
-    if (incremented == edges.cend()) {
-        incremented = edges.cbegin();
+    glm::dvec2 min{}, max{};
+    {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        view.getVisibleBounds(min, max);
     }
-    return incremented;
+    input.query(
+        [this, min, max]() { tiling.exportSvg("tiling.svg", min, max); });
+}
+
+/// @brief Save the tiling to `TILING_FILE`, unless it is being loaded from
+/// this file, which saving would truncate.
+void TilingApp::saveTiling() {
+    input.query([this]() {
+        if (loading) {
+            logError("The tiling is still loading.");
+            return;
+        }
+        tiling.save(TILING_FILE);
+    });
+}
+
+/// @brief Replace the tiling by the one saved in `TILING_FILE`, loaded in
+/// the background, see `loadBatch`.
+void TilingApp::loadTiling() {
+    edit([this]() {
+        std::shared_ptr<std::ifstream> file(
+            new std::ifstream(TILING_FILE, std::ios::binary));
+        if (!*file) {
+            logError("Failed to open the tiling file.");
+            return;
+        }
+        tiling.removeAllPolygons();
+        resetViewCenter();
+        display = Display::tiling;
+        loading = true;
+        loadBatch(file, std::make_shared<TilingReader>(*file));
+    });
 }
 
-std::list<Edge>::const_iterator
-TilingApp::circularPrev(std::list<Edge>::const_iterator& edge) const {
-    if (edges.empty()) {
-        return edge;
+/// @brief Apply the next `LOAD_BATCH` records of `reader` on the edit
+/// thread, then queue the next batch after the scene is published: the
+/// polygons loaded so far are drawn while the rest of the file is read.
+/// Edits queued meanwhile are rejected, since the edges of the loaded
+/// polygons come after them in the file. Loading stops when the window
+/// closes.
+/// @param file read by `reader`
+/// @param reader
+void TilingApp::loadBatch(const std::shared_ptr<std::ifstream>& file,
+                          const std::shared_ptr<TilingReader>& reader) {
+    if (!running) {
+        loading = false;
+        return;
     }
-    auto toDecrement = edge;
-    if (toDecrement == edges.cbegin()) {
-        toDecrement = edges.cend();
+    TilingRecord record{};
+    for (int n = 0; n < LOAD_BATCH; n++) {
+        if (!reader->next(record)) {
+            loading = false;
+            if (!reader->hasFailed()) {
+                std::clog << "Tiling loaded from " << TILING_FILE << " ("
+                          << tiling.getPolygons().size() << " polygons)."
+                          << std::endl;
+            }
+            return;
+        }
+        tiling.load(record);
     }
-    return std::prev(toDecrement);
+    editor.submit([this, file, reader]() {
+        loadBatch(file, reader);
+        publishScene();
+    });
 }
 
-void TilingApp::zoomIn() { viewMatrix *= 2.0; }
-
-void TilingApp::zoomOut() { viewMatrix /= 2.0; }
+/// @brief Zoom in by a factor 2 per step, out if `steps` is negative.
+void TilingApp::zoom(const int steps) {
+    std::lock_guard<std::mutex> lock(viewMutex);
+    view.viewMatrix *= std::pow(2.0f, static_cast<float>(steps));
+}
 
 void TilingApp::translate(const glm::vec2& direction) {
-    viewMatrix[2] -= direction * viewMatrix[0].x;
+    std::lock_guard<std::mutex> lock(viewMutex);
+    view.viewMatrix[2] -= direction * view.viewMatrix[0].x;
 }
 
 void TilingApp::handleKeyPress(const int key, const int mods) {
     switch (key) {
         case GLFW_KEY_3:
         case GLFW_KEY_KP_3:
-            addPolygon(3 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(3 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_4:
         case GLFW_KEY_KP_4:
-            addPolygon(4 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(4 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_5:
         case GLFW_KEY_KP_5:
-            addPolygon(5 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(5 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_6:
         case GLFW_KEY_KP_6:
-            addPolygon(6 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(6 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_7:
         case GLFW_KEY_KP_7:
-            addPolygon(7 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(7 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_8:
         case GLFW_KEY_KP_8:
-            addPolygon(8 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(8 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_9:
         case GLFW_KEY_KP_9:
-            addPolygon(9 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(9 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_0:
         case GLFW_KEY_KP_0:
-            addPolygon(10 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(10 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_1:
         case GLFW_KEY_KP_1:
-            addPolygon(11 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(11 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_2:
         case GLFW_KEY_KP_2:
-            addPolygon(12 + 10 * (mods & GLFW_MOD_SHIFT));
+            addPolygon(12 + 10 * (mods & GLFW_MOD_SHIFT), mods);
             break;
         case GLFW_KEY_TAB: {
             if (mods && GLFW_MOD_SHIFT) {
-                currentEdge = circularPrev(currentEdge);
+                edit([this]() { tiling.prevEdge(); });
             } else {
-                currentEdge = circularNext(currentEdge);
+                edit([this]() { tiling.nextEdge(); });
             }
             break;
         }
@@ -342,10 +683,54 @@ void TilingApp::handleKeyPress(const int key, const int mods) {
             removeLastPolygon();
             break;
         case GLFW_KEY_KP_ADD:
-            zoomIn();
+            input.zoom(1);
             break;
         case GLFW_KEY_KP_SUBTRACT:
-            zoomOut();
+            input.zoom(-1);
+            break;
+        case GLFW_KEY_C:
+            edit([this]() { tiling.recolorAllPolygons(); });
+            break;
+        case GLFW_KEY_G:
+            input.query(
+                [this]() { tiling.exportDualGraph("dual_graph", pool); });
+            break;
+        case GLFW_KEY_E:
+            exportSvg(mods & GLFW_MOD_SHIFT);
+            break;
+        case GLFW_KEY_S:
+            saveTiling();
+            break;
+        case GLFW_KEY_L:
+            loadTiling();
+            break;
+        case GLFW_KEY_M:
+            input.query([this]() { reportMemory(); });
+            break;
+        case GLFW_KEY_R:
+            rebuild();
+            break;
+        case GLFW_KEY_V:
+            input.query(
+                [this]() { tiling.getVertices().report(std::clog); });
+            break;
+        case GLFW_KEY_P:
+            togglePatch(Substitution::penrose);
+            break;
+        case GLFW_KEY_A:
+            togglePatch(Substitution::ammannBeenker);
+            break;
+        case GLFW_KEY_H:
+            nextHyperbolic();
+            break;
+        case GLFW_KEY_T:
+            nextPeriodic();
+            break;
+        case GLFW_KEY_LEFT_BRACKET:
+            changeDepth(-1);
+            break;
+        case GLFW_KEY_RIGHT_BRACKET:
+            changeDepth(1);
             break;
     }
 }
@@ -354,47 +739,107 @@ void TilingApp::handleScroll(const double xoffset, const double yoffset) {
     translate(0.05f * glm::vec2(-xoffset, yoffset));
 }
 
-void TilingApp::keyCallback(GLFWwindow* window, int key,
-                            __attribute__((unused)) int scancode,
-                            __attribute__((unused)) int action, int mods) {
+/// @brief Handle an event of the window, written to the input file if
+/// recording, unless replaying.
+void TilingApp::handleWindowEvent(InputEvent event) {
+    if (replaying) {
+        return;
+    }
+    if (recorder) {
+        event.time = glfwGetTime() - inputStart;
+        recorder->record(event);
+    }
+    handleEvent(event);
+}
 
+/// @brief Handle an event of the window or of the input file.
+void TilingApp::handleEvent(const InputEvent& event) {
+    switch (event.type) {
+        case InputEventType::key:
+            if (event.action == GLFW_PRESS || event.action == GLFW_REPEAT) {
+                handleKeyPress(event.code, event.mods);
+            }
+            break;
+        case InputEventType::cursor:
+            input.moveCursor(event.position.x, event.position.y);
+            break;
+        case InputEventType::button:
+            if (event.code == GLFW_MOUSE_BUTTON_LEFT &&
+                event.action == GLFW_PRESS) {
+                pickEdge();
+            }
+            break;
+        case InputEventType::resize: {
+            std::lock_guard<std::mutex> lock(viewMutex);
+            view.resize(event.code, event.action);
+            break;
+        }
+        case InputEventType::frame:
+            break;
+    }
+}
+
+void TilingApp::keyCallback(GLFWwindow* window, int key,
+                            __attribute__((unused)) int scancode, int action,
+                            int mods) {
     void* ptr = glfwGetWindowUserPointer(window);
     auto* app = static_cast<TilingApp*>(ptr);
+    InputEvent event{};
+    event.type = InputEventType::key;
+    event.code = key;
+    event.action = action;
+    event.mods = mods;
+    app->handleWindowEvent(event);
+}
 
-    if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-        app->handleKeyPress(key, mods);
-    }
+void TilingApp::resetViewCenter() {
+    std::lock_guard<std::mutex> lock(viewMutex);
+    view.viewMatrix[2] = glm::vec2(0.0f, 0.0f);
+    view.origin = glm::dvec2(0.0, 0.0);
 }
 
-void TilingApp::resetViewCenter() { viewMatrix[2] = glm::vec2(0.0f, 0.0f); }
+/// @brief Move the origin of the view to the window center once the view
+/// has moved far from it, see `View::recenter`.
+/// @return whether the origin moved
+bool TilingApp::recenterView() {
+    std::lock_guard<std::mutex> lock(viewMutex);
+    return view.recenter();
+}
 
-void TilingApp::cursorPosCallback(__attribute__((unused)) GLFWwindow* window,
-                                  double xpos, double ypos) {
-    static double xposPrevious = 0.0;
-    static double yposPrevious = 0.0;
+void TilingApp::cursorPosCallback(GLFWwindow* window, double xpos,
+                                  double ypos) {
     void* ptr = glfwGetWindowUserPointer(window);
     auto* app = static_cast<TilingApp*>(ptr);
+    InputEvent event{};
+    event.type = InputEventType::cursor;
+    event.position = glm::dvec2(xpos, ypos);
+    app->handleWindowEvent(event);
+}
 
-    if (xposPrevious != 0.0 || yposPrevious != 0.0) {
-        app->handleScroll((xpos - xposPrevious) / 30.0,
-                          (ypos - yposPrevious) / 30.0);
-    }
-    xposPrevious = xpos;
-    yposPrevious = ypos;
+void TilingApp::mouseButtonCallback(GLFWwindow* window, int button,
+                                    int action, int mods) {
+    void* ptr = glfwGetWindowUserPointer(window);
+    auto* app = static_cast<TilingApp*>(ptr);
+    InputEvent event{};
+    event.type = InputEventType::button;
+    event.code = button;
+    event.action = action;
+    event.mods = mods;
+    app->handleWindowEvent(event);
 }
 
 void TilingApp::framebufferSizeCallback(__attribute__((unused))
                                         GLFWwindow* window,
                                         int width, int height) {
-    glViewport(0, 0, width, height);
     void* ptr = glfwGetWindowUserPointer(window);
     auto* app = static_cast<TilingApp*>(ptr);
-    glUseProgram(app->shaderProgram);
-    int positionUniform =
-        glGetUniformLocation(app->shaderProgram, "windowSize");
-    float smallerSide = std::min(width, height);
-    glUniform2f(positionUniform, smallerSide / width, smallerSide / height);
+    InputEvent event{};
+    event.type = InputEventType::resize;
+    event.code = width;
+    event.action = height;
+    app->handleWindowEvent(event);
 }
+
 void TilingApp::windowMaximizeCallback(GLFWwindow* window, int maximized) {
     const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
     if (maximized) {
@@ -1,79 +1,159 @@
 #ifndef TILING_APP_H
 #define TILING_APP_H
 
-#include "edge.h"
-#include "polygon.h"
+#include "hyperbolicTiling.h"
+#include "inputQueue.h"
+#include "inputRecord.h"
+#include "periodicTiling.h"
+#include "renderer.h"
+#include "scene.h"
+#include "substitutionTiling.h"
+#include "threadPool.h"
+#include "tiling.h"
+#include "tripleBuffer.h"
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
-#include <glm/mat3x2.hpp>
-#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <glm/vec2.hpp>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <string>
 #include <vector>
 
-// TODO update with the implementation
+/// @brief What the window shows.
+enum class Display { tiling, patch, hyperbolic, periodic };
 
-/// @brief Manages Polygon instances, an edge cursor and an OpenGL shader
-/// program. Non-copyable.
+/// @brief Displays a Tiling in a GLFW window and edits it from user input.
+/// Non-copyable.
 ///
-/// @arg `currentEdge` Edge cursor that you can move from edge to edge to
-/// choose where to add a new polygon.
-/// This cursor can only access polygon sides stored in `edges`.
+/// Three threads share the work so that long edits never stall the window:
+/// the main thread handles GLFW events, the `editor` thread applies edits to
+/// the tiling in order and publishes a Scene snapshot after each one, and
+/// the render thread owns the OpenGL context and draws the latest snapshot.
 ///
-/// @arg `edges` Polygon sides accessible by the edge cursor `currentEdge`.
-/// Linked list with bidirectional circular traversal using
-/// `TilingApp::circularNext` and `TilingApp::circularPrev`.
+/// @arg `tiling` Polygons and edge cursor, only accessed by `editor`.
 ///
-/// @arg `links` Shared Polygon sides unreachable by the edge cursor
-/// `currentEdge`. Hashmap mapping edge to edge.
+/// @arg `patch` Substitution tiling shown instead of `tiling` depending on
+/// `display`, generated around the view. Only accessed by `editor`.
 ///
-/// @note
-/// In principle, overlapping/shared edges of connected polygons should be
-/// stored in `links` while other edges should be stored in
-/// `edges`. In practice, the detection of overlapping edges when instantiating
-/// a new polygon is not perfect. There can remain undetected overlapping
-/// polygon sides in `edges`. However, the current implementation has the useful
-/// feature that adjacent elements in `edges` are always adjacent sides, and
-/// that polygons are always all connected.
+/// @arg `hyperbolic` Hyperbolic tiling shown instead of `tiling` depending
+/// on `display`, generated down to the pixel size. Only accessed by
+/// `editor`.
+///
+/// @arg `pool` Worker threads for whole-tiling passes.
+///
+/// @arg `periodic` Archimedean tiling shown instead of `tiling` depending on
+/// `display`, streamed in chunks generated on `pool` around the view, which
+/// wake the main thread when they are ready. Only accessed by `editor`.
+///
+/// @arg `scenes` Snapshots passed from `editor` to the render thread.
+///
+/// @arg `view` Camera shared by the main and render threads, guarded by
+/// `viewMutex`. Its origin follows the camera, and the scene of `tiling` is
+/// captured relative to it again when it moves.
+///
+/// @arg `input` Events of the current frame, only accessed by the main
+/// thread. The main thread waits for each frame to be swapped before
+/// applying them, so fast mice and held keys cost one update per frame.
+///
+/// @arg `recorder` Writes the events of the window and the end of each
+/// frame to a file, if recording. Only accessed by the main thread.
+///
+/// @arg `replayed` Recorded events fed back instead of those of the window,
+/// if replaying, with the same frames, see `replay`.
 class TilingApp {
-    std::vector<std::shared_ptr<Polygon>> polygons{};
-    std::list<Edge>::const_iterator currentEdge{};
-    std::list<Edge> edges{};
-    std::unordered_map<Edge, Edge, EdgeHash> links{};
-    unsigned shaderProgram{};
-    glm::mat3x2 viewMatrix{};
+    Tiling tiling{};
+    // while a file is loaded in batches, during which `tiling` has polygons
+    // but no accessible edges yet and edits are rejected. Only accessed by
+    // `editor`.
+    bool loading = false;
+    SubstitutionTiling patch{};
+    HyperbolicTiling hyperbolic{};
+    Display display = Display::tiling;
+    ThreadPool pool{};
+    // declared after `pool` to wait for its chunks before the workers stop
+    PeriodicTiling periodic{[]() { glfwPostEmptyEvent(); }};
+    TripleBuffer<Scene> scenes{};
+    // stamps the published scenes, each slot of `scenes` only sees some
+    unsigned publishCount{};
+    View view{};
+    mutable std::mutex viewMutex{};
+    std::atomic<bool> running{false};
+    InputQueue input{};
+    std::unique_ptr<InputRecorder> recorder{};
+    std::vector<InputEvent> replayed{};
+    bool replaying = false;
+    // whether to replay as fast as possible rather than at the recorded times
+    bool replayFast = false;
+    // GLFW time of the start of the recording or replay
+    double inputStart{};
+    std::mutex frameMutex{};
+    std::condition_variable frameSwapped{};
+    unsigned frameCount{};
+    // reported by the render thread
+    std::atomic<std::size_t> gpuBufferBytes{0};
     GLFWwindow* window{};
+    // declared last to finish pending edits before anything else is destroyed
+    ThreadPool editor{1};
 
     void log(const char* log) const;
     void initGlfwCallbacks();
-    void destroyGL(const bool destroyProgram = true);
-    std::list<Edge>::const_iterator
-    circularNext(std::list<Edge>::const_iterator& edge) const;
-    std::list<Edge>::const_iterator
-    circularPrev(std::list<Edge>::const_iterator& edge) const;
+    void edit(const std::function<void()>& function);
+    void publishScene();
+    void renderLoop();
+    void waitForFrame();
+    void waitForFrames(const unsigned nbFrames);
+    void waitForEdits();
+    void processInput();
+    void handleWindowEvent(InputEvent event);
+    void handleEvent(const InputEvent& event);
+    void runReplay();
     void handleKeyPress(const int key, const int mods);
     void handleScroll(const double xoffset, const double yoffset);
-    void zoomIn();
-    void zoomOut();
+    void zoom(const int steps);
+    void pickEdge();
     void translate(const glm::vec2& direction);
     void resetViewCenter();
+    bool recenterView();
+    void addPolygon(const int nbSides, const int mods);
+    void removeAllPolygons();
+    void removeLastPolygon();
+    void rebuild();
+    void reportMemory() const;
+    void exportSvg(const bool clipToView);
+    void saveTiling();
+    void loadTiling();
+    void loadBatch(const std::shared_ptr<std::ifstream>& file,
+                   const std::shared_ptr<TilingReader>& reader);
+    void togglePatch(const Substitution substitution);
+    void nextHyperbolic();
+    void nextPeriodic();
+    void changeDepth(const int steps);
+    bool updateDisplay();
+    bool updatePatch();
+    bool updateHyperbolic();
+    bool updatePeriodic();
 
   public:
     TilingApp(GLFWwindow* window);
     ~TilingApp();
     TilingApp(const TilingApp&) = delete;
     TilingApp& operator=(const TilingApp&) = delete;
-    void addPolygon(int nbSides);
-    void removeAllPolygons();
-    void removeLastPolygon();
-    void render() const;
-    void debug() const;
+    void run();
+    void debug();
+    bool record(const std::string& filename);
+    bool replay(const std::string& filename, const bool fast);
 
     static void keyCallback(GLFWwindow* window, int key, int scancode,
                             int action, int mods);
     static void framebufferSizeCallback(GLFWwindow* window, int width,
                                         int height);
     static void cursorPosCallback(GLFWwindow* window, double xpos, double ypos);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action,
+                                    int mods);
     static void windowMaximizeCallback(GLFWwindow* window, int maximized);
 };
 
@@ -0,0 +1,247 @@
+#include "tilingFile.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// bytes gathered before writing to the file, or read at once
+static const std::size_t BUFFER_CAPACITY = 1 << 16;
+static const char* HEADER = "tiling 1";
+
+TilingWriter::TilingWriter(const std::string& filename)
+    : file(filename, std::ios::binary) {
+    if (!file) {
+        logError("Failed to create the tiling file.");
+        return;
+    }
+    valid = true;
+    buffer.reserve(BUFFER_CAPACITY);
+    char line[16] = {};
+    write(line, std::snprintf(line, sizeof(line), "%s\n", HEADER));
+}
+
+TilingWriter::~TilingWriter() {
+    if (valid) {
+        logError("Tiling file left incomplete.");
+    }
+}
+
+bool TilingWriter::isValid() const { return valid; }
+
+/// @brief Write a polygon line, with enough digits to read the same
+/// vertices back.
+void TilingWriter::writePolygon(const int nbSides, const int color,
+                                const glm::dvec2& a, const glm::dvec2& b) {
+    char line[128] = {};
+    write(line, std::snprintf(line, sizeof(line),
+                              "polygon %d %d %.17g %.17g %.17g %.17g\n",
+                              nbSides, color, a.x, a.y, b.x, b.y));
+}
+
+void TilingWriter::writeEdge(const int polygon, const int side) {
+    char line[32] = {};
+    write(line,
+          std::snprintf(line, sizeof(line), "edge %d %d\n", polygon, side));
+}
+
+void TilingWriter::writeLink(const int polygon, const int side,
+                             const int otherPolygon, const int otherSide) {
+    char line[64] = {};
+    write(line, std::snprintf(line, sizeof(line), "link %d %d %d %d\n",
+                              polygon, side, otherPolygon, otherSide));
+}
+
+void TilingWriter::writeCursor(const int polygon, const int side) {
+    char line[32] = {};
+    write(line,
+          std::snprintf(line, sizeof(line), "cursor %d %d\n", polygon, side));
+}
+
+/// @brief Write the remaining buffered lines.
+/// @return whether the whole file was written successfully
+bool TilingWriter::close() {
+    if (!valid) {
+        return false;
+    }
+    flush();
+    valid = false;
+    file.close();
+    return static_cast<bool>(file);
+}
+
+void TilingWriter::write(const char* text, const int size) {
+    if (!valid) {
+        return;
+    }
+    if (buffer.size() + size > BUFFER_CAPACITY) {
+        flush();
+    }
+    buffer.insert(buffer.end(), text, text + size);
+}
+
+void TilingWriter::flush() {
+    file.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+TilingReader::TilingReader(std::istream& stream)
+    : stream(stream), buffer(BUFFER_CAPACITY + 1, '\0') {}
+
+/// @brief Read the next polygon, edge, link or cursor line.
+/// @return false at the end of the stream or on the first invalid line,
+/// see `hasFailed`
+bool TilingReader::next(TilingRecord& record) {
+    const char* line = nullptr;
+    const char* lineEnd = nullptr;
+    while (!failed && readLine(line, lineEnd)) {
+        lineNumber++;
+        while (line < lineEnd && (*line == ' ' || *line == '\t')) {
+            line++;
+        }
+        if (line == lineEnd || *line == '#' || *line == '\r') {
+            continue;
+        }
+        if (!headerRead) {
+            const std::size_t size = std::strlen(HEADER);
+            if (static_cast<std::size_t>(lineEnd - line) < size ||
+                std::strncmp(line, HEADER, size) != 0) {
+                fail("Not a tiling file, or of a newer version.");
+                return false;
+            }
+            headerRead = true;
+            continue;
+        }
+        if (!parseRecord(line, lineEnd, record)) {
+            fail("Invalid line in the tiling file.");
+            return false;
+        }
+        return true;
+    }
+    if (!failed && !headerRead) {
+        fail("Empty tiling file.");
+    }
+    return false;
+}
+
+/// @brief Whether the stream had an invalid line.
+bool TilingReader::hasFailed() const { return failed; }
+
+/// @brief Find the next line in the buffer, reading the stream when the
+/// buffer holds no complete line. The buffer grows to hold longer lines.
+/// @param line first character
+/// @param lineEnd newline or null character after the last one
+/// @return whether there was a line left
+bool TilingReader::readLine(const char*& line, const char*& lineEnd) {
+    while (true) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(&buffer[begin], '\n', end - begin));
+        if (newline) {
+            line = &buffer[begin];
+            lineEnd = newline;
+            begin = newline - buffer.data() + 1;
+            return true;
+        }
+        if (!stream) {
+            // last line without a newline
+            if (begin == end) {
+                return false;
+            }
+            line = &buffer[begin];
+            lineEnd = &buffer[end];
+            begin = end;
+            return true;
+        }
+        // keep the partial line at the start of the buffer
+        std::memmove(buffer.data(), &buffer[begin], end - begin);
+        end -= begin;
+        begin = 0;
+        if (end == buffer.size() - 1) {
+            buffer.resize(2 * end + 1);
+        }
+        stream.read(&buffer[end], buffer.size() - 1 - end);
+        end += stream.gcount();
+        buffer[end] = '\0';
+    }
+}
+
+/// @brief Parse an integer at `cursor` and move after it.
+static bool parseInt(const char*& cursor, const char* end, int& value) {
+    char* parsed = nullptr;
+    long number = std::strtol(cursor, &parsed, 10);
+    if (parsed == cursor || parsed > end) {
+        return false;
+    }
+    value = static_cast<int>(number);
+    cursor = parsed;
+    return true;
+}
+
+/// @brief Parse a floating point number at `cursor` and move after it.
+static bool parseDouble(const char*& cursor, const char* end, double& value) {
+    char* parsed = nullptr;
+    value = std::strtod(cursor, &parsed);
+    if (parsed == cursor || parsed > end) {
+        return false;
+    }
+    cursor = parsed;
+    return true;
+}
+
+/// @brief Whether the line starts with `keyword` followed by a blank, and
+/// if so move after it.
+static bool parseKeyword(const char*& cursor, const char* end,
+                         const char* keyword) {
+    const std::size_t size = std::strlen(keyword);
+    if (static_cast<std::size_t>(end - cursor) <= size ||
+        std::strncmp(cursor, keyword, size) != 0 ||
+        (cursor[size] != ' ' && cursor[size] != '\t')) {
+        return false;
+    }
+    cursor += size;
+    return true;
+}
+
+/// @brief Parse a line starting with a keyword.
+/// @return whether the line is valid
+bool TilingReader::parseRecord(const char* line, const char* lineEnd,
+                               TilingRecord& record) const {
+    const char* cursor = line;
+    bool valid = false;
+    if (parseKeyword(cursor, lineEnd, "polygon")) {
+        record.type = TilingRecordType::polygon;
+        valid = parseInt(cursor, lineEnd, record.nbSides) &&
+                parseInt(cursor, lineEnd, record.color) &&
+                parseDouble(cursor, lineEnd, record.a.x) &&
+                parseDouble(cursor, lineEnd, record.a.y) &&
+                parseDouble(cursor, lineEnd, record.b.x) &&
+                parseDouble(cursor, lineEnd, record.b.y);
+    } else if (parseKeyword(cursor, lineEnd, "edge")) {
+        record.type = TilingRecordType::edge;
+        valid = parseInt(cursor, lineEnd, record.polygon) &&
+                parseInt(cursor, lineEnd, record.side);
+    } else if (parseKeyword(cursor, lineEnd, "link")) {
+        record.type = TilingRecordType::link;
+        valid = parseInt(cursor, lineEnd, record.polygon) &&
+                parseInt(cursor, lineEnd, record.side) &&
+                parseInt(cursor, lineEnd, record.otherPolygon) &&
+                parseInt(cursor, lineEnd, record.otherSide);
+    } else if (parseKeyword(cursor, lineEnd, "cursor")) {
+        record.type = TilingRecordType::cursor;
+        valid = parseInt(cursor, lineEnd, record.polygon) &&
+                parseInt(cursor, lineEnd, record.side);
+    }
+    // nothing but blanks after the numbers
+    while (valid && cursor < lineEnd) {
+        valid = *cursor == ' ' || *cursor == '\t' || *cursor == '\r';
+        cursor++;
+    }
+    return valid;
+}
+
+void TilingReader::fail(const char* error) {
+    failed = true;
+    std::string message =
+        std::string(error) + " (line " + std::to_string(lineNumber) + ")";
+    logError(message.c_str());
+}
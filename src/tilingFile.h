@@ -0,0 +1,97 @@
+#ifndef TILING_FILE_H
+#define TILING_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <glm/vec2.hpp>
+#include <istream>
+#include <string>
+#include <vector>
+
+/// @brief Kind of line of a tiling file.
+enum class TilingRecordType { polygon, edge, link, cursor };
+
+/// @brief Line of a tiling file, see `TilingWriter` for the format.
+struct TilingRecord {
+    TilingRecordType type = TilingRecordType::polygon;
+    // polygon: number of sides, color and first two vertices
+    int nbSides{};
+    int color{};
+    glm::dvec2 a{};
+    glm::dvec2 b{};
+    // edge, link and cursor: side `side` of polygon `polygon`, linked to
+    // side `otherSide` of polygon `otherPolygon`
+    int polygon{};
+    int side{};
+    int otherPolygon{};
+    int otherSide{};
+};
+
+/// @brief Writes a tiling to a text file one line per record, through a
+/// buffer flushed to the file whenever it is full. Non-copyable.
+///
+/// The file starts with the line `tiling 1` (the version of the format),
+/// followed by lines made of a keyword and numbers separated by spaces:
+/// - `polygon NBSIDES COLOR AX AY BX BY` for each polygon, in id order,
+///   with its first two vertices (written exactly)
+/// - `edge POLYGON SIDE` for each edge accessible to the cursor, in order
+/// - `link POLYGON SIDE OTHER_POLYGON OTHER_SIDE` for each pair of linked
+///   sides
+/// - `cursor POLYGON SIDE` for the edge under the cursor
+///
+/// Polygons are referred to by id, so they come before the other lines.
+/// Empty lines and lines starting with `#` are ignored.
+class TilingWriter {
+    std::ofstream file{};
+    std::vector<char> buffer{};
+    bool valid = false;
+
+    void write(const char* text, const int size);
+    void flush();
+
+  public:
+    TilingWriter(const std::string& filename);
+    ~TilingWriter();
+    TilingWriter(const TilingWriter&) = delete;
+    TilingWriter& operator=(const TilingWriter&) = delete;
+    bool isValid() const;
+    void writePolygon(const int nbSides, const int color, const glm::dvec2& a,
+                      const glm::dvec2& b);
+    void writeEdge(const int polygon, const int side);
+    void writeLink(const int polygon, const int side, const int otherPolygon,
+                   const int otherSide);
+    void writeCursor(const int polygon, const int side);
+    bool close();
+};
+
+/// @brief Reads the records of a tiling file one at a time. Non-copyable.
+///
+/// The stream is read in blocks into a single buffer, and lines are parsed
+/// in place, so that reading doesn't allocate per line or number: a file is
+/// loaded a few records at a time, while the records already read are
+/// drawn.
+class TilingReader {
+    std::istream& stream;
+    // read bytes, followed by a null character stopping the number parsers
+    std::vector<char> buffer{};
+    // unparsed bytes
+    std::size_t begin{};
+    std::size_t end{};
+    int lineNumber{};
+    bool headerRead = false;
+    bool failed = false;
+
+    bool readLine(const char*& line, const char*& lineEnd);
+    bool parseRecord(const char* line, const char* lineEnd,
+                     TilingRecord& record) const;
+    void fail(const char* error);
+
+  public:
+    TilingReader(std::istream& stream);
+    TilingReader(const TilingReader&) = delete;
+    TilingReader& operator=(const TilingReader&) = delete;
+    bool next(TilingRecord& record);
+    bool hasFailed() const;
+};
+
+#endif /* TILING_FILE_H */
@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/// @brief Lock-free triple buffer passing values of type `T` from one writer
+/// thread to one reader thread. Non-copyable.
+///
+/// The writer fills the back buffer and publishes it, the reader picks up the
+/// latest published buffer as its front buffer. Neither ever waits: the
+/// writer can publish again while the reader holds its front buffer, and
+/// intermediate values the reader didn't pick up are overwritten.
+/// Buffers are reused, so `T` can keep allocated storage between values.
+template <typename T> class TripleBuffer {
+    static const int INDEX_MASK = 3;
+    // set in `middle` when it holds a value the reader hasn't picked up
+    static const int NEW_VALUE = 4;
+
+    T buffers[3]{};
+    int back = 0;
+    std::atomic<int> middle{1};
+    int front = 2;
+
+  public:
+    TripleBuffer() {}
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /// @brief Buffer the writer may modify.
+    T& getBack() { return buffers[back]; }
+
+    /// @brief Hand the back buffer over to the reader (writer side).
+    void publish() { back = middle.exchange(back | NEW_VALUE) & INDEX_MASK; }
+
+    /// @brief Pick up the latest published buffer if any (reader side).
+    /// @return whether the front buffer changed
+    bool update() {
+        if (!(middle.load() & NEW_VALUE)) {
+            return false;
+        }
+        front = middle.exchange(front) & INDEX_MASK;
+        return true;
+    }
+
+    /// @brief Buffer the reader may read.
+    const T& getFront() const { return buffers[front]; }
+};
+
+#endif /* TRIPLE_BUFFER_H */
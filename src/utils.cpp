@@ -1,4 +1,5 @@
 #include "utils.h"
+#include <cassert>
 #include <glm/glm.hpp>
 #include <glm/gtx/color_space.hpp>
 #include <iostream>
@@ -6,6 +7,11 @@
 using namespace glm;
 
 int DEFAULT_WINDOW_SIZE = 800;
+const int NB_COLORS = white + 1;
+// most sides of a polygon, well above the 21 of the keyboard shortcuts
+const int MAX_NB_SIDES = 64;
+// two vertices closer than this are considered the same (edges are 0.2 long)
+const float DISTANCE_THRESHOLD = 1e-3;
 
 /// @brief Rotate `point` by `radianAngle` around `(0, 0)`.
 /// @param radianAngle
@@ -17,9 +23,26 @@ vec2 rotate(float radianAngle, const vec2& point) {
     return transpose(edge) * vec2(cos(radianAngle), sin(radianAngle));
 }
 
+/// @brief Vertices of the regular polygon with `nbSides` sides of length 1
+/// whose first side goes from (0, 0) to (1, 0), in counter-clockwise order.
+/// Vertex 0 is duplicated at the end so that the last side can be fetched
+/// like the others.
+/// @param nbSides (should be at least 2)
+std::vector<dvec2> regularPolygon(const int nbSides) {
+    assert(nbSides >= 2);
+    std::vector<dvec2> points(nbSides + 1);
+    dvec2 xy = dvec2(0.0);
+    double closingAngle = 2.0 * pi<double>() / nbSides;
+    for (int n = 0; n <= nbSides; n++) {
+        points[n] = xy;
+        xy += dvec2(cos(n * closingAngle), sin(n * closingAngle));
+    }
+    return points;
+}
+
 PolygonColor nextColor() {
     static int color = 0;
-    color %= 11;
+    color %= NB_COLORS;
     return static_cast<PolygonColor>(color++);
 }
 
@@ -2,6 +2,7 @@
 #define UTILS_H
 
 #include <glm/glm.hpp>
+#include <vector>
 
 #define RED "\033[1;31m"
 #define GREEN "\033[1;32m"
@@ -23,10 +24,15 @@ enum PolygonColor {
     white
 };
 
+extern const int NB_COLORS;
+extern const int MAX_NB_SIDES;
+
 extern int DEFAULT_WINDOW_SIZE;
+extern const float DISTANCE_THRESHOLD;
 
 glm::vec2 rotate(float radianAngle,
                  const glm::vec2& vector = glm::vec2(1.0, 0.0));
+std::vector<glm::dvec2> regularPolygon(const int nbSides);
 PolygonColor nextColor();
 glm::vec3 getColor(const PolygonColor& color);
 glm::vec3 cursorColor();
@@ -0,0 +1,253 @@
+#include "vertexClassifier.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+/// @brief Register the vertices of `polygon` and update their types.
+/// @param polygon
+void VertexClassifier::addPolygon(const Polygon& polygon) {
+    for (int n = 0; n < polygon.nbSides; n++) {
+        dvec2 position = polygon.getVertex(n);
+        dvec2 toCenter = polygon.getCenter() - position;
+        addCorner(position, Corner(&polygon, atan2(toCenter.y, toCenter.x)));
+        classify(*find(position));
+    }
+}
+
+/// @brief Unregister the vertices of `polygon` and update their types.
+/// Vertices that no longer belong to any polygon are forgotten.
+/// @param polygon
+void VertexClassifier::removePolygon(const Polygon& polygon) {
+    for (int n = 0; n < polygon.nbSides; n++) {
+        Vertex* vertex = find(polygon.getVertex(n));
+        if (!vertex) {
+            continue;
+        }
+        auto& corners = vertex->corners;
+        corners.erase(std::remove_if(corners.begin(), corners.end(),
+                                     [&polygon](const Corner& corner) {
+                                         return corner.polygon == &polygon;
+                                     }),
+                      corners.end());
+        classify(*vertex);
+        if (corners.empty()) {
+            GridCell key(vertex->position, DISTANCE_THRESHOLD);
+            auto& cell = grid.at(key);
+            cell.erase(cell.begin() + (vertex - &cell[0]));
+            if (cell.empty()) {
+                grid.erase(key);
+            }
+            vertexCount--;
+        }
+    }
+}
+
+/// @brief Classify the vertices of `polygons` from scratch.
+///
+/// Corners are computed for ranges of polygons in parallel and grouped into
+/// vertices sequentially, then vertex types are computed in parallel.
+/// @param polygons
+/// @param pool
+void VertexClassifier::build(
+    const std::vector<std::shared_ptr<Polygon>>& polygons, ThreadPool& pool) {
+    clear();
+    std::vector<int> offsets(polygons.size() + 1, 0);
+    for (std::size_t id = 0; id < polygons.size(); id++) {
+        offsets[id + 1] = offsets[id] + polygons[id]->nbSides;
+    }
+    std::vector<dvec2> positions(offsets.back());
+    std::vector<Corner> corners(offsets.back(), Corner(nullptr, 0.0));
+    pool.parallelFor(0, polygons.size(), [&](int begin, int end) {
+        for (int id = begin; id < end; id++) {
+            const Polygon& polygon = *polygons[id];
+            dvec2 center = polygon.getCenter();
+            for (int n = 0; n < polygon.nbSides; n++) {
+                dvec2 position = polygon.getVertex(n);
+                dvec2 toCenter = center - position;
+                positions[offsets[id] + n] = position;
+                corners[offsets[id] + n] =
+                    Corner(&polygon, atan2(toCenter.y, toCenter.x));
+            }
+        }
+    });
+    for (std::size_t n = 0; n < corners.size(); n++) {
+        addCorner(positions[n], corners[n]);
+    }
+
+    std::vector<Vertex*> allVertices{};
+    allVertices.reserve(vertexCount);
+    for (auto& cell : grid) {
+        for (auto& vertex : cell.second) {
+            allVertices.push_back(&vertex);
+        }
+    }
+    pool.parallelFor(0, allVertices.size(), [&](int begin, int end) {
+        for (int n = begin; n < end; n++) {
+            allVertices[n]->type = typeOf(*allVertices[n]);
+        }
+    });
+    for (auto vertex : allVertices) {
+        countType(vertex->type, 1);
+    }
+}
+
+void VertexClassifier::clear() {
+    grid.clear();
+    histogram.clear();
+    vertexCount = 0;
+}
+
+/// @brief Number of interior vertices per vertex configuration.
+const std::map<std::string, int>& VertexClassifier::getHistogram() const {
+    return histogram;
+}
+
+int VertexClassifier::getVertexCount() const { return vertexCount; }
+
+int VertexClassifier::getInteriorVertexCount() const {
+    int count = 0;
+    for (auto& type : histogram) {
+        count += type.second;
+    }
+    return count;
+}
+
+/// @brief Print the vertex type histogram to `stream`.
+///
+/// A k-uniform tiling has at most k vertex types, so a patch with k vertex
+/// types is at least k-uniform.
+void VertexClassifier::report(std::ostream& stream) const {
+    stream << "Vertices: " << vertexCount << " ("
+           << getInteriorVertexCount() << " interior)" << std::endl;
+    for (auto& type : histogram) {
+        stream << "  " << type.first << ": " << type.second << std::endl;
+    }
+    if (!histogram.empty()) {
+        stream << "At least " << histogram.size() << "-uniform ("
+               << histogram.size() << " vertex types)." << std::endl;
+    }
+}
+
+/// @brief Angle around `position` not covered by polygons, in radians.
+float VertexClassifier::getFreeAngle(const dvec2& position) const {
+    float angle = 2.0 * pi<float>();
+    if (const Vertex* vertex = find(position)) {
+        for (auto& corner : vertex->corners) {
+            angle -= corner.polygon->getInteriorAngle();
+        }
+    }
+    return angle;
+}
+
+VertexClassifier::Vertex* VertexClassifier::find(const dvec2& position) {
+    const VertexClassifier* constThis = this;
+    return const_cast<Vertex*>(constThis->find(position));
+}
+
+/// @brief Return the vertex at `position` or nullptr.
+/// Neighboring cells are searched too as `position` may be rounded to a
+/// different cell than the stored vertex.
+const VertexClassifier::Vertex*
+VertexClassifier::find(const dvec2& position) const {
+    GridCell center(position, DISTANCE_THRESHOLD);
+    for (long long dx = -1; dx <= 1; dx++) {
+        for (long long dy = -1; dy <= 1; dy++) {
+            auto cell = grid.find(GridCell(center.x + dx, center.y + dy));
+            if (cell == grid.end()) {
+                continue;
+            }
+            for (auto& vertex : cell->second) {
+                if (distance(vertex.position, position) < DISTANCE_THRESHOLD) {
+                    return &vertex;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+/// @brief Add `corner` to the vertex at `position`, creating the vertex if
+/// needed.
+void VertexClassifier::addCorner(const dvec2& position,
+                                 const Corner& corner) {
+    Vertex* vertex = find(position);
+    if (!vertex) {
+        auto& cell = grid[GridCell(position, DISTANCE_THRESHOLD)];
+        cell.emplace_back();
+        vertex = &cell.back();
+        vertex->position = position;
+        vertexCount++;
+    }
+    vertex->corners.push_back(corner);
+}
+
+/// @brief Recompute the type of `vertex` and update the histogram.
+void VertexClassifier::classify(Vertex& vertex) {
+    countType(vertex.type, -1);
+    vertex.type = typeOf(vertex);
+    countType(vertex.type, 1);
+}
+
+/// @brief Type of `vertex`, empty if it isn't an interior vertex.
+///
+/// The type lists the number of sides of the polygons around the vertex in
+/// cyclic order, starting from the rotation or reflection which is
+/// lexicographically smallest (so 4.3.3.4.3 is written 3.3.4.3.4).
+std::string VertexClassifier::typeOf(const Vertex& vertex) {
+    float angleSum = 0.0;
+    for (auto& corner : vertex.corners) {
+        angleSum += corner.polygon->getInteriorAngle();
+    }
+    if (std::abs(angleSum - 2.0 * pi<float>()) > 1e-3) {
+        return "";
+    }
+
+    auto corners = vertex.corners;
+    std::sort(corners.begin(), corners.end(),
+              [](const Corner& lhs, const Corner& rhs) {
+                  return lhs.direction < rhs.direction;
+              });
+    std::vector<int> sides{};
+    for (auto& corner : corners) {
+        sides.push_back(corner.polygon->nbSides);
+    }
+    std::vector<int> smallest = sides;
+    for (int reflection = 0; reflection < 2; reflection++) {
+        for (std::size_t rotation = 0; rotation < sides.size(); rotation++) {
+            std::rotate(sides.begin(), sides.begin() + 1, sides.end());
+            smallest = std::min(smallest, sides);
+        }
+        std::reverse(sides.begin(), sides.end());
+    }
+    std::string type{};
+    for (std::size_t n = 0; n < smallest.size(); n++) {
+        type += (n ? "." : "") + std::to_string(smallest[n]);
+    }
+    return type;
+}
+
+void VertexClassifier::countType(const std::string& type, const int increment) {
+    if (type.empty()) {
+        return;
+    }
+    int& count = histogram[type];
+    count += increment;
+    if (count == 0) {
+        histogram.erase(type);
+    }
+}
+
+/// @brief Bytes used by the vertices hashed in the grid and the histogram.
+std::size_t VertexClassifier::getMemoryUsage() const {
+    std::size_t bytes = unorderedMapBytes(grid) + mapBytes(histogram);
+    for (auto& cell : grid) {
+        bytes += vectorBytes(cell.second);
+        for (auto& vertex : cell.second) {
+            bytes += vectorBytes(vertex.corners);
+        }
+    }
+    return bytes;
+}
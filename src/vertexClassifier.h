@@ -0,0 +1,64 @@
+#ifndef VERTEX_CLASSIFIER_H
+#define VERTEX_CLASSIFIER_H
+
+#include "gridCell.h"
+#include "memoryUsage.h"
+#include "polygon.h"
+#include "threadPool.h"
+#include <glm/vec2.hpp>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Classifies the vertices of a tiling by their vertex configuration
+/// (e.g. 3.3.4.3.4), incrementally as polygons are added and removed.
+///
+/// A vertex is interior when the interior angles of the polygons around it sum
+/// up to 360°. Only interior vertices have a type, and the histogram counts
+/// interior vertices per type.
+///
+/// Polygons are referenced by address: a polygon must be removed from the
+/// classifier before it is deleted.
+class VertexClassifier {
+    struct Corner {
+        const Polygon* polygon{};
+        // angle from the vertex to the polygon center, orders the corners
+        float direction{};
+        Corner(const Polygon* polygon, float direction)
+            : polygon(polygon), direction(direction) {};
+    };
+    struct Vertex {
+        glm::dvec2 position{};
+        std::vector<Corner> corners{};
+        std::string type{};
+    };
+    // vertices are stored in the grid cell of their position
+    std::unordered_map<GridCell, std::vector<Vertex>, GridCellHash> grid{};
+    std::map<std::string, int> histogram{};
+    int vertexCount{};
+
+    const Vertex* find(const glm::dvec2& position) const;
+    Vertex* find(const glm::dvec2& position);
+    void addCorner(const glm::dvec2& position, const Corner& corner);
+    void classify(Vertex& vertex);
+    static std::string typeOf(const Vertex& vertex);
+    void countType(const std::string& type, const int increment);
+
+  public:
+    void addPolygon(const Polygon& polygon);
+    void removePolygon(const Polygon& polygon);
+    void build(const std::vector<std::shared_ptr<Polygon>>& polygons,
+               ThreadPool& pool);
+    void clear();
+    const std::map<std::string, int>& getHistogram() const;
+    int getVertexCount() const;
+    int getInteriorVertexCount() const;
+    float getFreeAngle(const glm::dvec2& position) const;
+    void report(std::ostream& stream) const;
+    std::size_t getMemoryUsage() const;
+};
+
+#endif /* VERTEX_CLASSIFIER_H */
@@ -0,0 +1,319 @@
+#include "worldGeometry.h"
+#include "utils.h"
+#include <algorithm>
+#include <glm/glm.hpp>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace glm;
+
+// side of the cells indexing polygons, a few times the side of a polygon
+static const double INDEX_CELL_SIZE = 0.5;
+
+/// @brief Compute `matrix * (x, y, 1)` for `count` points given in structure of
+/// arrays layout, using the widest vector instructions the build targets.
+/// @param matrix
+/// @param x
+/// @param y
+/// @param count should be a multiple of `SIMD_WIDTH`
+/// @param worldX
+/// @param worldY
+void transformPoints(const dmat3x2& matrix, const double* x, const double* y,
+                     const int count, double* worldX, double* worldY) {
+    int n = 0;
+#if defined(__AVX2__)
+    const __m256d a4 = _mm256_set1_pd(matrix[0].x);
+    const __m256d b4 = _mm256_set1_pd(matrix[0].y);
+    const __m256d c4 = _mm256_set1_pd(matrix[1].x);
+    const __m256d d4 = _mm256_set1_pd(matrix[1].y);
+    const __m256d e4 = _mm256_set1_pd(matrix[2].x);
+    const __m256d f4 = _mm256_set1_pd(matrix[2].y);
+    for (; n + 4 <= count; n += 4) {
+        __m256d px = _mm256_loadu_pd(x + n);
+        __m256d py = _mm256_loadu_pd(y + n);
+#if defined(__FMA__)
+        __m256d wx = _mm256_fmadd_pd(a4, px, _mm256_fmadd_pd(c4, py, e4));
+        __m256d wy = _mm256_fmadd_pd(b4, px, _mm256_fmadd_pd(d4, py, f4));
+#else
+        __m256d wx = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(a4, px), _mm256_mul_pd(c4, py)), e4);
+        __m256d wy = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(b4, px), _mm256_mul_pd(d4, py)), f4);
+#endif
+        _mm256_storeu_pd(worldX + n, wx);
+        _mm256_storeu_pd(worldY + n, wy);
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128d a2 = _mm_set1_pd(matrix[0].x);
+    const __m128d b2 = _mm_set1_pd(matrix[0].y);
+    const __m128d c2 = _mm_set1_pd(matrix[1].x);
+    const __m128d d2 = _mm_set1_pd(matrix[1].y);
+    const __m128d e2 = _mm_set1_pd(matrix[2].x);
+    const __m128d f2 = _mm_set1_pd(matrix[2].y);
+    for (; n + 2 <= count; n += 2) {
+        __m128d px = _mm_loadu_pd(x + n);
+        __m128d py = _mm_loadu_pd(y + n);
+        __m128d wx = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(a2, px), _mm_mul_pd(c2, py)), e2);
+        __m128d wy = _mm_add_pd(
+            _mm_add_pd(_mm_mul_pd(b2, px), _mm_mul_pd(d2, py)), f2);
+        _mm_storeu_pd(worldX + n, wx);
+        _mm_storeu_pd(worldY + n, wy);
+    }
+#endif
+    transformPointsScalar(matrix, x + n, y + n, count - n, worldX + n,
+                          worldY + n);
+}
+
+/// @brief Portable version of `transformPoints`.
+void transformPointsScalar(const dmat3x2& matrix, const double* x,
+                           const double* y, const int count, double* worldX,
+                           double* worldY) {
+    for (int n = 0; n < count; n++) {
+        worldX[n] = matrix[0].x * x[n] + matrix[1].x * y[n] + matrix[2].x;
+        worldY[n] = matrix[0].y * x[n] + matrix[1].y * y[n] + matrix[2].y;
+    }
+}
+
+/// @brief Instruction set used by `transformPoints`.
+const char* vertexKernelName() {
+#if defined(__AVX2__) && defined(__FMA__)
+    return "AVX2+FMA";
+#elif defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+/// @brief Append the world-space vertices of `polygon`, whose id should be
+/// the number of polygons already stored.
+void WorldGeometry::addPolygon(const Polygon& polygon) {
+    addUnitPolygon(polygon);
+    int id = size();
+    int count = unitXs[polygon.nbSides].size();
+    offsets.push_back(offsets.back() + count);
+    xs.resize(offsets.back());
+    ys.resize(offsets.back());
+    boundsMin.emplace_back();
+    boundsMax.emplace_back();
+    transform(polygon, id);
+    indexPolygon(id);
+}
+
+void WorldGeometry::removeLastPolygon() {
+    unindexLastPolygon();
+    offsets.pop_back();
+    xs.resize(offsets.back());
+    ys.resize(offsets.back());
+    boundsMin.pop_back();
+    boundsMax.pop_back();
+}
+
+/// @brief Recompute the vertices of all `polygons` in one batch, ranges of
+/// polygons being transformed in parallel.
+/// @param polygons polygons indexed by id
+/// @param pool
+void WorldGeometry::build(const std::vector<std::shared_ptr<Polygon>>& polygons,
+                          ThreadPool& pool) {
+    offsets.assign(1, 0);
+    offsets.reserve(polygons.size() + 1);
+    for (auto& polygon : polygons) {
+        addUnitPolygon(*polygon);
+        offsets.push_back(offsets.back() + unitXs[polygon->nbSides].size());
+    }
+    xs.resize(offsets.back());
+    ys.resize(offsets.back());
+    boundsMin.resize(polygons.size());
+    boundsMax.resize(polygons.size());
+    pool.parallelFor(0, polygons.size(), [&](int begin, int end) {
+        for (int id = begin; id < end; id++) {
+            transform(*polygons[id], id);
+        }
+    });
+    cells.clear();
+    for (int id = 0; id < size(); id++) {
+        indexPolygon(id);
+    }
+}
+
+void WorldGeometry::clear() {
+    xs.clear();
+    ys.clear();
+    offsets.assign(1, 0);
+    boundsMin.clear();
+    boundsMax.clear();
+    cells.clear();
+}
+
+/// @brief Number of polygons.
+int WorldGeometry::size() const { return offsets.size() - 1; }
+
+/// @brief Number of stored vertices, padding included.
+int WorldGeometry::getVertexCount() const { return xs.size(); }
+
+/// @brief World-space position of `vertex` (from 0 to nbSides included) of
+/// `polygon`.
+dvec2 WorldGeometry::getVertex(const int polygon, const int vertex) const {
+    return dvec2(xs[offsets[polygon] + vertex], ys[offsets[polygon] + vertex]);
+}
+
+/// @brief Bounding box of `polygon`.
+void WorldGeometry::getBounds(const int polygon, dvec2& min,
+                              dvec2& max) const {
+    min = boundsMin[polygon];
+    max = boundsMax[polygon];
+}
+
+/// @brief Whether the bounding box of `polygon` intersects the box from
+/// `min` to `max`.
+bool WorldGeometry::intersects(const int polygon, const dvec2& min,
+                               const dvec2& max) const {
+    return boundsMin[polygon].x <= max.x && boundsMin[polygon].y <= max.y &&
+           boundsMax[polygon].x >= min.x && boundsMax[polygon].y >= min.y;
+}
+
+/// @brief Whether `point` is inside `polygon` or on its sides.
+bool WorldGeometry::contains(const int polygon, const dvec2& point) const {
+    if (!intersects(polygon, point, point)) {
+        return false;
+    }
+    // vertices are counterclockwise, the point is left of every side
+    // (padding repeats the first vertex, adding empty sides)
+    const int count = offsets[polygon + 1] - offsets[polygon];
+    for (int n = 0; n + 1 < count; n++) {
+        dvec2 a = getVertex(polygon, n);
+        dvec2 side = getVertex(polygon, n + 1) - a;
+        dvec2 toPoint = point - a;
+        if (side.x * toPoint.y - side.y * toPoint.x < -DISTANCE_THRESHOLD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Id of a polygon containing `point`, -1 if there is none.
+int WorldGeometry::findPolygon(const dvec2& point) const {
+    auto cell = cells.find(GridCell(point, INDEX_CELL_SIZE));
+    if (cell == cells.end()) {
+        return -1;
+    }
+    for (int id : cell->second) {
+        if (contains(id, point)) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+/// @brief Ids of the polygons whose bounding box intersects the box from
+/// `min` to `max`, in increasing order.
+/// @param min
+/// @param max
+/// @param ids replaced by the result
+void WorldGeometry::findPolygons(const dvec2& min, const dvec2& max,
+                                 std::vector<int>& ids) const {
+    ids.clear();
+    GridCell first(min, INDEX_CELL_SIZE);
+    GridCell last(max, INDEX_CELL_SIZE);
+    // a large box is cheaper to test polygon by polygon
+    if ((last.x - first.x + 1) * (last.y - first.y + 1) >=
+        static_cast<long long>(cells.size())) {
+        for (int id = 0; id < size(); id++) {
+            if (intersects(id, min, max)) {
+                ids.push_back(id);
+            }
+        }
+        return;
+    }
+    for (long long x = first.x; x <= last.x; x++) {
+        for (long long y = first.y; y <= last.y; y++) {
+            auto cell = cells.find(GridCell(x, y));
+            if (cell == cells.end()) {
+                continue;
+            }
+            for (int id : cell->second) {
+                if (intersects(id, min, max)) {
+                    ids.push_back(id);
+                }
+            }
+        }
+    }
+    // polygons overlapping several cells
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+void WorldGeometry::addUnitPolygon(const Polygon& polygon) {
+    const int nbSides = polygon.nbSides;
+    if (static_cast<int>(unitXs.size()) <= nbSides) {
+        unitXs.resize(nbSides + 1);
+        unitYs.resize(nbSides + 1);
+    }
+    if (!unitXs[nbSides].empty()) {
+        return;
+    }
+    int padded = (nbSides + SIMD_WIDTH) / SIMD_WIDTH * SIMD_WIDTH;
+    // padding slots repeat the first vertex to keep bounds correct
+    for (int n = 0; n < padded; n++) {
+        dvec2 point = polygon.getPoints()[n <= nbSides ? n : 0];
+        unitXs[nbSides].push_back(point.x);
+        unitYs[nbSides].push_back(point.y);
+    }
+}
+
+void WorldGeometry::transform(const Polygon& polygon, const int id) {
+    const int offset = offsets[id];
+    const int count = offsets[id + 1] - offset;
+    transformPoints(polygon.getModelMatrix(), unitXs[polygon.nbSides].data(),
+                    unitYs[polygon.nbSides].data(), count, &xs[offset],
+                    &ys[offset]);
+    auto rangeX = std::minmax_element(&xs[offset], &xs[offset] + count);
+    auto rangeY = std::minmax_element(&ys[offset], &ys[offset] + count);
+    boundsMin[id] = dvec2(*rangeX.first, *rangeY.first);
+    boundsMax[id] = dvec2(*rangeX.second, *rangeY.second);
+}
+
+void WorldGeometry::indexPolygon(const int id) {
+    GridCell first(boundsMin[id], INDEX_CELL_SIZE);
+    GridCell last(boundsMax[id], INDEX_CELL_SIZE);
+    for (long long x = first.x; x <= last.x; x++) {
+        for (long long y = first.y; y <= last.y; y++) {
+            cells[GridCell(x, y)].push_back(id);
+        }
+    }
+}
+
+/// @brief Remove the last polygon from `cells`, where it is the last id.
+void WorldGeometry::unindexLastPolygon() {
+    const int id = size() - 1;
+    GridCell first(boundsMin[id], INDEX_CELL_SIZE);
+    GridCell last(boundsMax[id], INDEX_CELL_SIZE);
+    for (long long x = first.x; x <= last.x; x++) {
+        for (long long y = first.y; y <= last.y; y++) {
+            auto cell = cells.find(GridCell(x, y));
+            cell->second.pop_back();
+            if (cell->second.empty()) {
+                cells.erase(cell);
+            }
+        }
+    }
+}
+
+/// @brief Bytes used by the vertices, bounding boxes and grid cells.
+std::size_t WorldGeometry::getMemoryUsage() const {
+    std::size_t bytes = vectorBytes(xs) + vectorBytes(ys) +
+                        vectorBytes(offsets) + vectorBytes(boundsMin) +
+                        vectorBytes(boundsMax) + unorderedMapBytes(cells);
+    for (std::size_t n = 0; n < unitXs.size(); n++) {
+        bytes += vectorBytes(unitXs[n]) + vectorBytes(unitYs[n]);
+    }
+    for (auto& cell : cells) {
+        bytes += vectorBytes(cell.second);
+    }
+    return bytes;
+}
@@ -0,0 +1,73 @@
+#ifndef WORLD_GEOMETRY_H
+#define WORLD_GEOMETRY_H
+
+#include "gridCell.h"
+#include "memoryUsage.h"
+#include "polygon.h"
+#include "threadPool.h"
+#include <glm/mat3x2.hpp>
+#include <glm/vec2.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// number of doubles processed at once by the widest vertex kernel, a
+// multiple of the widths of the others
+const int SIMD_WIDTH = 4;
+
+void transformPoints(const glm::dmat3x2& matrix, const double* x,
+                     const double* y, const int count, double* worldX,
+                     double* worldY);
+void transformPointsScalar(const glm::dmat3x2& matrix, const double* x,
+                           const double* y, const int count, double* worldX,
+                           double* worldY);
+const char* vertexKernelName();
+
+/// @brief World-space vertices of the polygons of a tiling, in structure of
+/// arrays layout, with the bounding box of each polygon. Vertices are in
+/// double precision like the polygons, so that shared sides are still found
+/// far from the origin.
+///
+/// Polygon `p` has its vertices at indices `offsets[p]` to
+/// `offsets[p] + nbSides` included (the first vertex is repeated last), the
+/// following slots up to a multiple of `SIMD_WIDTH` being padding.
+///
+/// `cells` indexes polygons by the grid cells their bounding box overlaps,
+/// to find the polygons near a point without scanning all of them.
+class WorldGeometry {
+    // unit polygons in structure of arrays layout, indexed by number of sides
+    std::vector<std::vector<double>> unitXs{};
+    std::vector<std::vector<double>> unitYs{};
+    std::vector<double> xs{};
+    std::vector<double> ys{};
+    std::vector<int> offsets{0};
+    std::vector<glm::dvec2> boundsMin{};
+    std::vector<glm::dvec2> boundsMax{};
+    // polygon ids in increasing order
+    std::unordered_map<GridCell, std::vector<int>, GridCellHash> cells{};
+
+    void addUnitPolygon(const Polygon& polygon);
+    void transform(const Polygon& polygon, const int id);
+    void indexPolygon(const int id);
+    void unindexLastPolygon();
+
+  public:
+    void addPolygon(const Polygon& polygon);
+    void removeLastPolygon();
+    void build(const std::vector<std::shared_ptr<Polygon>>& polygons,
+               ThreadPool& pool);
+    void clear();
+    int size() const;
+    int getVertexCount() const;
+    glm::dvec2 getVertex(const int polygon, const int vertex) const;
+    void getBounds(const int polygon, glm::dvec2& min, glm::dvec2& max) const;
+    bool intersects(const int polygon, const glm::dvec2& min,
+                    const glm::dvec2& max) const;
+    bool contains(const int polygon, const glm::dvec2& point) const;
+    int findPolygon(const glm::dvec2& point) const;
+    void findPolygons(const glm::dvec2& min, const glm::dvec2& max,
+                      std::vector<int>& ids) const;
+    std::size_t getMemoryUsage() const;
+};
+
+#endif /* WORLD_GEOMETRY_H */